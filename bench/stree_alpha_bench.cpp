@@ -0,0 +1,157 @@
+/* Memory and query speed of the alphabet trees of stree_alpha.h
+* against the char SUFFIXTREE, on the same random corpus.
+*
+*   g++ -std=c++11 -O2 -Isrc bench/stree_alpha_bench.cpp src/[a-z]*.cpp -lpthread
+*   ./a.out [strings] [length] [queries] [pattern length]
+*
+* DNA strings of ACGT are indexed as chars, as 2-bit bases and as
+* bytes; the words of a text of random words, as chars and as 32-bit
+* word IDs. Half of the patterns are taken from the strings, half
+* have their last symbol changed.
+*/
+
+#include "suffix_tree.h"
+#include "stree_alpha.h"
+#include <stdio.h>
+#include <sys/time.h>
+
+static double bench_now( void )
+{
+	struct timeval t;
+	gettimeofday( &t, NULL );
+	return t.tv_sec + t.tv_usec * 1e-6;
+}
+
+static void bench_report( const char *name, double build, size_t bytes, unsigned int num,
+	double query, unsigned long long hits )
+{
+	printf( "%-18s build %6.2f s  %8.1f MB  %10.0f q/s  %llu hits\n",
+		name, build, bytes / 1e6, num / query, hits );
+}
+
+/* The char tree over strings, queried with stree_count_occurrences */
+static void bench_char( const char *name, vector< string > &strings, vector< string > &queries )
+{
+	SUFFIXTREE tree;
+	unsigned long long hits;
+	unsigned int i, embedding_num, stringid_num;
+	double t, build;
+
+	t = bench_now();
+	stree_init( &tree );
+	for( i = 0; i < strings.size(); i++ )
+		stree_insert_string_len( &tree, ( char * )strings[i].c_str(), strings[i].size() );
+	stree_count_strings( &tree );
+	build = bench_now() - t;
+	t = bench_now();
+	for( i = 0, hits = 0; i < queries.size(); i++ ){
+		if( stree_count_occurrences( &tree, ( char * )queries[i].c_str(), queries[i].size(),
+			&embedding_num, &stringid_num ) == 0 )
+			hits += embedding_num;
+	}
+	bench_report( name, build, stree_memory_usage( &tree ), queries.size(), bench_now() - t, hits );
+	stree_destroy( &tree );
+}
+
+/* An alphabet tree over strings of symbols, queried with
+* stree_alpha_count and, for as many patterns, stree_alpha_occurrences */
+template< class A >
+static void bench_alpha( const char *name, vector< vector< typename A::symbol > > &strings,
+	vector< vector< typename A::symbol > > &queries )
+{
+	stree_alpha_tree< A > tree;
+	const stree_alpha_occ *occ;
+	unsigned long long hits, starts;
+	unsigned int i, k, n;
+	double t, build;
+
+	t = bench_now();
+	stree_alpha_init( &tree );
+	for( i = 0; i < strings.size(); i++ )
+		stree_alpha_insert( &tree, &strings[i][0], strings[i].size() );
+	stree_alpha_finish( &tree );
+	build = bench_now() - t;
+	t = bench_now();
+	for( i = 0, hits = 0; i < queries.size(); i++ )
+		hits += stree_alpha_count( &tree, &queries[i][0], queries[i].size() );
+	bench_report( name, build, stree_alpha_memory( &tree ), queries.size(), bench_now() - t, hits );
+	t = bench_now();
+	for( i = 0, starts = 0; i < queries.size(); i++ ){
+		n = stree_alpha_occurrences( &tree, &queries[i][0], queries[i].size(), &occ );
+		for( k = 0; k < n; k++ )
+			starts += occ[k].str_start;
+	}
+	printf( "%-18s occurrences %10.0f q/s  (%llu)\n", "", queries.size() / ( bench_now() - t ), starts );
+	stree_alpha_free( &tree );
+}
+
+int main( int argc, char **argv )
+{
+	unsigned int num = argc > 1 ? atoi( argv[1] ) : 20000;
+	unsigned int len = argc > 2 ? atoi( argv[2] ) : 100;
+	unsigned int qnum = argc > 3 ? atoi( argv[3] ) : 200000;
+	unsigned int plen = argc > 4 ? atoi( argv[4] ) : 12;
+	vector< string > dna( num ), dna_q( qnum ), words( num ), words_q( qnum );
+	vector< vector< unsigned char > > base( num ), base_q( qnum ), byte( num ), byte_q( qnum );
+	vector< vector< unsigned int > > token( num ), token_q( qnum );
+	vector< string > vocabulary( 5000 );
+	unsigned int i, k, s, w, wlen;
+
+	if( len <= plen || len < 10 ){
+		fprintf( stderr, "the strings must be longer than the patterns, and 10 or more\n" );
+		return 1;
+	}
+	srand( 1 );
+	for( i = 0; i < num; i++ ){
+		for( k = 0; k < len; k++ )
+			dna[i] += "ACGT"[rand() % 4];
+	}
+	for( i = 0; i < qnum; i++ ){
+		s = rand() % num;
+		dna_q[i] = dna[s].substr( rand() % ( len - plen ), plen );
+		if( rand() % 2 )
+			dna_q[i][plen - 1] = "ACGT"[rand() % 4];
+	}
+	for( i = 0; i < num; i++ ){
+		for( k = 0; k < len; k++ )
+			base[i].push_back( stree_alpha_dna_code( dna[i][k] ) );
+		byte[i].assign( dna[i].begin(), dna[i].end() );
+	}
+	for( i = 0; i < qnum; i++ ){
+		for( k = 0; k < plen; k++ )
+			base_q[i].push_back( stree_alpha_dna_code( dna_q[i][k] ) );
+		byte_q[i].assign( dna_q[i].begin(), dna_q[i].end() );
+	}
+
+	/* a text of words: len / 5 words a string, of 2 to 9 letters */
+	for( w = 0; w < vocabulary.size(); w++ ){
+		for( wlen = 2 + rand() % 8, k = 0; k < wlen; k++ )
+			vocabulary[w] += 'a' + rand() % 26;
+	}
+	for( i = 0; i < num; i++ ){
+		for( k = 0; k < len / 5; k++ ){
+			w = rand() % vocabulary.size();
+			token[i].push_back( w );
+			words[i] += vocabulary[w] + " ";
+		}
+	}
+	for( i = 0; i < qnum; i++ ){
+		s = rand() % num;
+		k = rand() % ( len / 5 - 1 );
+		token_q[i].assign( token[s].begin() + k, token[s].begin() + k + 2 );
+		if( rand() % 2 )
+			token_q[i][1] = rand() % vocabulary.size();
+		words_q[i] = " " + vocabulary[token_q[i][0]] + " " + vocabulary[token_q[i][1]] + " ";
+		if( k == 0 )
+			words_q[i].erase( 0, 1 );
+	}
+
+	printf( "%u DNA strings of %u bases, %u patterns of %u\n", num, len, qnum, plen );
+	bench_char( "char SUFFIXTREE", dna, dna_q );
+	bench_alpha< stree_alpha_dna >( "2-bit DNA", base, base_q );
+	bench_alpha< stree_alpha_byte >( "byte", byte, byte_q );
+	printf( "%u texts of %u words, %u patterns of 2 words\n", num, len / 5, qnum );
+	bench_char( "char SUFFIXTREE", words, words_q );
+	bench_alpha< stree_alpha_token >( "uint32 tokens", token, token_q );
+	return 0;
+}
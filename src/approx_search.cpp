@@ -0,0 +1,154 @@
+#include "approx_search.h"
+#include <vector>
+
+/* Push the children of a node with a non-empty edge */
+static void ctree_push_children( const COMPACTTREE *c, unsigned int node, unsigned int e,
+	vector< pair<unsigned int, unsigned int> > &stack )
+{
+	unsigned int ch;
+	for( ch = c->nodes[node+1].first_child; ch > c->nodes[node].first_child; ch-- ){
+		if( c->first_char[ch - 1] != 0 )
+			stack.push_back( make_pair( ch - 1, e ) );
+	}
+}
+
+/* Report a hit
+* Return:     1 if the callback stops the search, 0 otherwise
+*/
+
+static int ctree_approx_hit( unsigned int node, unsigned int length, unsigned int distance,
+	CTREE_APPROX_FN fn, void *arg )
+{
+	CTREE_APPROX hit;
+	hit.node = node;
+	hit.length = length;
+	hit.distance = distance;
+	return fn( arg, &hit ) != 0;
+}
+
+/* Find the substrings of the pattern's length with at most k
+* mismatches. Each edge label is compared in one pass, and the
+* walk leaves it at the (k+1)-th mismatch.
+* Parameter:  c:            the COMPACTTREE
+*             pattern, len: the pattern
+*             k:            the most mismatches allowed
+*             fn, arg:      called for every hit
+* Return:     0 if successful, 1 if stopped by the callback
+* Last modified: 10/18/2026
+*/
+
+int ctree_search_hamming( const COMPACTTREE *c, const char *pattern, unsigned int len,
+	unsigned int k, CTREE_APPROX_FN fn, void *arg )
+{
+	vector< pair<unsigned int, unsigned int> > stack;   /*(node, mismatches above it)*/
+	const char *label;
+	unsigned int u, e, d, end;
+
+	if( c->node_count == 0 )
+		return 0;
+	if( len == 0 )
+		return ctree_approx_hit( 0, 0, 0, fn, arg );
+	ctree_push_children( c, 0, 0, stack );
+	while( !stack.empty() ){
+		u = stack.back().first;
+		e = stack.back().second;
+		stack.pop_back();
+		d = c->char_depth[c->parent[u]];
+		end = c->char_depth[u] < len ? c->char_depth[u] : len;
+		label = c->text + c->nodes[u].edge_start - d;
+		for( ; d < end && e <= k; d++ ){
+			if( label[d] == 0 )
+				e = k + 1;
+			else if( label[d] != pattern[d] )
+				e++;
+		}
+		if( e > k )
+			continue;
+		if( end == len ){
+			if( ctree_approx_hit( u, len, e, fn, arg ) )
+				return 1;
+			continue;
+		}
+		ctree_push_children( c, u, e, stack );
+	}
+	return 0;
+}
+
+/* Find the substrings within edit distance k of the pattern. The
+* column of the distances between the pattern prefixes and the path
+* is extended by each label character, in the band of width 2k+1
+* around the diagonal, the rest being over k. Only the band is
+* stored: cell j of the column of depth d is col[d*(2k+1)+j-d+k],
+* so the columns take O((len+k)*k) memory. The walk leaves a
+* path when the whole band is over k, and stops at the first depth
+* within k, which covers every occurrence below it.
+* Parameter:  c:            the COMPACTTREE
+*             pattern, len: the pattern
+*             k:            the largest distance allowed
+*             fn, arg:      called for every hit
+* Return:     0 if successful, 1 if stopped by the callback
+* Last modified: 10/18/2026
+*/
+
+int ctree_search_edit( const COMPACTTREE *c, const char *pattern, unsigned int len,
+	unsigned int k, CTREE_APPROX_FN fn, void *arg )
+{
+	vector< pair<unsigned int, unsigned int> > stack;
+	vector<unsigned int> col;   /*cell j of depth d at col[d*(2k+1)+j-d+k]*/
+	const unsigned int inf = k + 1;
+	unsigned int *prev, *cur;
+	unsigned int u, d, end, j, lo, hi, v, best;
+	const char *label;
+
+	if( c->node_count == 0 )
+		return 0;
+	if( len <= k )
+		return ctree_approx_hit( 0, 0, len, fn, arg );
+	col.resize( ( len + k + 1 ) * ( 2 * k + 1 ) );
+	for( j = 0; j <= k; j++ )
+		col[k+j] = j;
+	ctree_push_children( c, 0, 0, stack );
+	while( !stack.empty() ){
+		u = stack.back().first;
+		stack.pop_back();
+		d = c->char_depth[c->parent[u]];
+		end = c->char_depth[u] < len + k ? c->char_depth[u] : len + k;
+		label = c->text + c->nodes[u].edge_start - d;
+		for( best = 0; d < end; d++ ){
+			if( label[d] == 0 )
+				break;
+			/* column d+1 from column d, cells j in [d+1-k, d+1+k];
+			prev[j] and cur[j] index the bands directly */
+			prev = &col[2 * k * d + k];
+			cur = prev + 2 * k;
+			lo = d + 1 > k ? d + 1 - k : 0;
+			hi = d + 1 + k < len ? d + 1 + k : len;
+			best = inf;
+			for( j = lo; j <= hi; j++ ){
+				if( j == 0 )
+					v = d + 1;
+				else{
+					v = prev[j-1] + ( label[d] != pattern[j-1] );
+					if( j <= d + k && prev[j] + 1 < v )
+						v = prev[j] + 1;
+					if( j > lo && cur[j-1] + 1 < v )
+						v = cur[j-1] + 1;
+				}
+				cur[j] = v < inf ? v : inf;
+				if( cur[j] < best )
+					best = cur[j];
+			}
+			if( best > k )
+				break;
+			if( hi == len && cur[len] <= k ){
+				if( ctree_approx_hit( u, d + 1, cur[len], fn, arg ) )
+					return 1;
+				best = inf;
+				break;
+			}
+		}
+		if( d == c->char_depth[u] && best <= k )
+			ctree_push_children( c, u, 0, stack );
+	}
+	return 0;
+}
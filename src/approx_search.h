@@ -0,0 +1,29 @@
+#pragma once
+
+#include "compact_tree.h"
+
+/* Approximate pattern search over a compact tree.
+*
+* The tree is walked depth first, one edge label at a time, with a
+* mismatch count (Hamming distance) or a banded edit distance column
+* carried down the path; a subtree is left as soon as no string in
+* it can be within k of the pattern.
+*
+* Each hit is a node: every occurrence under it, c->occ[occ_begin]
+* on, starts a substring of the given length within distance k of
+* the pattern. Every occurrence is covered by one hit only; for the
+* edit distance, that of the shortest substring within k.
+*/
+
+typedef struct ctree_approx{
+	unsigned int node;          /*the occurrences are those under node*/
+	unsigned int length;        /*the length of the substring matched*/
+	unsigned int distance;
+}CTREE_APPROX;
+
+typedef int ( *CTREE_APPROX_FN )( void *arg, const CTREE_APPROX *hit );
+
+int ctree_search_hamming( const COMPACTTREE *c, const char *pattern, unsigned int len,
+	unsigned int k, CTREE_APPROX_FN fn, void *arg );
+int ctree_search_edit( const COMPACTTREE *c, const char *pattern, unsigned int len,
+	unsigned int k, CTREE_APPROX_FN fn, void *arg );
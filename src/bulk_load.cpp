@@ -0,0 +1,254 @@
+#include "suffix_tree.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#define STREE_READ_CHUNK  ( 1 << 20 )
+
+static double stree_now( void )
+{
+	struct timeval tv;
+	gettimeofday( &tv, NULL );
+	return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* Check the limits before a string of len characters is added
+* Return:     1 if the string would exceed a limit, 0 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int stree_load_full( STREE_LOAD_STATS *stats, unsigned int max_strings,
+	unsigned long long max_bytes, unsigned int len )
+{
+	if( max_strings != 0 && stats->strings >= max_strings )
+		return 1;
+	if( max_bytes != 0 && stats->bytes + len > max_bytes )
+		return 1;
+	return 0;
+}
+
+/* Insert the complete records found in a buffer. Each record is
+* copied once, straight into the text buffer of the tree.
+* Parameter:  tree:        the SUFFIXTREE
+*             buf, len:    the input bytes
+*             eof:         1 if no more input follows the buffer
+*             format:      STREE_FORMAT_LINES or STREE_FORMAT_FASTA
+*             max_strings: stop after this many strings, 0 for no limit
+*             max_bytes:   stop before this many characters, 0 for no limit
+*             stats:       the counters to update
+*             scanned:     the bytes at the start of buf already searched
+*                          for the end of its first record, for the record
+*                          left unfinished (for return)
+*             status:      set to 1 when a limit is reached,
+*                          -1 if an insertion fails
+* Return:     the number of bytes consumed
+* Last modified:  10/18/2026
+*/
+
+static size_t stree_load_records( SUFFIXTREE *tree, char *buf, size_t len, int eof, int format,
+	unsigned int max_strings, unsigned long long max_bytes, STREE_LOAD_STATS *stats,
+	size_t *scanned, int *status )
+{
+	char *p, *q, *end, *line, *next, *text, *from;
+	size_t pos, n;
+	unsigned int k;
+
+	/* the searches start at from, or the record if it comes later */
+	from = buf + *scanned;
+	*scanned = 0;
+	pos = 0;
+	end = buf + len;
+	while( pos < len ){
+		p = buf + pos;
+		q = p > from ? p : from;
+		if( format == STREE_FORMAT_LINES ){
+			if( ( next = ( char * )memchr( q, '\n', end - q ) ) == NULL ){
+				if( !eof ){
+					*scanned = len - pos;
+					break;
+				}
+				next = end;
+			}
+			n = next - p;
+			if( n > 0 && p[n-1] == '\r' )
+				n--;
+			if( n > 0 ){
+				if( stree_load_full( stats, max_strings, max_bytes, n ) ){
+					*status = 1;
+					break;
+				}
+				if( stree_insert_string_len( tree, p, n ) ){
+					*status = -1;
+					break;
+				}
+				stats->strings++;
+				stats->bytes += n;
+			}
+			pos = next < end ? next - buf + 1 : len;
+			continue;
+		}
+
+		/* FASTA: skip to the next header, then find where the record ends */
+		if( *p != '>' ){
+			if( ( next = ( char * )memchr( q, '\n', end - q ) ) == NULL ){
+				if( !eof ){
+					*scanned = len - pos;
+					break;
+				}
+				pos = len;
+				continue;
+			}
+			pos = next - buf + 1;
+			continue;
+		}
+		/* the header line is searched from its start, as the search
+		of the record ends may have gone past it */
+		if( ( line = ( char * )memchr( p, '\n', end - p ) ) == NULL ){
+			if( !eof )
+				break;
+			pos = len;
+			continue;
+		}
+		for( next = line > from ? line : from; ; next++ ){
+			if( ( next = ( char * )memchr( next, '\n', end - next ) ) == NULL || next + 1 == end ){
+				/* a last newline is searched again, with the byte after it */
+				if( !eof )
+					*scanned = ( next == NULL ? end : next ) - p;
+				next = eof ? end : NULL;
+				break;
+			}
+			if( next[1] == '>' ){
+				next++;
+				break;
+			}
+		}
+		if( next == NULL )
+			break;
+		n = next - line;
+		if( ( text = stree_reserve_text( tree, n ) ) == NULL ){
+			*status = -1;
+			break;
+		}
+		for( k = 0, line++; line < next; line++ ){
+			if( *line != '\n' && *line != '\r' && *line != 0 )
+				text[k++] = *line;
+		}
+		if( k > 0 ){
+			if( stree_load_full( stats, max_strings, max_bytes, k ) ){
+				*status = 1;
+				break;
+			}
+			if( stree_commit_string( tree, k ) ){
+				*status = -1;
+				break;
+			}
+			stats->strings++;
+			stats->bytes += k;
+		}
+		pos = next - buf;
+	}
+	return pos;
+}
+
+/* Build the tree from a file descriptor holding one string per
+* line or FASTA records. Regular files are mapped, anything else is
+* read in chunks. Empty lines and empty records are skipped, and the
+* header lines of FASTA records are not kept. The input must not
+* contain 0 bytes.
+* Parameter:  tree:        the SUFFIXTREE
+*             fd:          the open file descriptor
+*             format:      STREE_FORMAT_AUTO, STREE_FORMAT_LINES or
+*                          STREE_FORMAT_FASTA
+*             max_strings: stop after this many strings, 0 for no limit
+*             max_bytes:   stop before this many characters, 0 for no limit
+*             stats:       the counters and throughput (for return),
+*                          may be NULL
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_load_fd( SUFFIXTREE *tree, int fd, int format,
+	unsigned int max_strings, unsigned long long max_bytes, STREE_LOAD_STATS *stats )
+{
+	STREE_LOAD_STATS local;
+	struct stat st;
+	char *buf, *map;
+	size_t size, len, used, scanned;
+	ssize_t got;
+	int status, eof;
+	double start;
+
+	if( stats == NULL )
+		stats = &local;
+	memset( ( void * )stats, 0, sizeof( STREE_LOAD_STATS ) );
+	start = stree_now();
+	status = 0;
+	scanned = 0;
+
+	if( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0 ){
+		if( ( map = ( char * )mmap( NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 ) ) == MAP_FAILED )
+			return 1;
+		madvise( map, st.st_size, MADV_SEQUENTIAL );
+		if( format == STREE_FORMAT_AUTO )
+			format = map[0] == '>' ? STREE_FORMAT_FASTA : STREE_FORMAT_LINES;
+		stats->input_bytes = stree_load_records( tree, map, st.st_size, 1, format,
+			max_strings, max_bytes, stats, &scanned, &status );
+		munmap( map, st.st_size );
+	}
+	else{
+		/* a pipe or socket: keep the unfinished record between reads,
+		and how far it was searched, so its body is searched once */
+		size = STREE_READ_CHUNK;
+		len = 0;
+		eof = 0;
+		if( ( buf = ( char * )malloc( size ) ) == NULL )
+			return 1;
+		while( !eof && status == 0 ){
+			if( len == size ){
+				if( ( map = ( char * )realloc( buf, size * 2 ) ) == NULL ){
+					status = -1;
+					break;
+				}
+				buf = map;
+				size *= 2;
+			}
+			if( ( got = read( fd, buf + len, size - len ) ) < 0 ){
+				status = -1;
+				break;
+			}
+			eof = got == 0;
+			len += got;
+			if( len == 0 )
+				break;
+			if( format == STREE_FORMAT_AUTO )
+				format = buf[0] == '>' ? STREE_FORMAT_FASTA : STREE_FORMAT_LINES;
+			used = stree_load_records( tree, buf, len, eof, format, max_strings, max_bytes, stats,
+				&scanned, &status );
+			stats->input_bytes += used;
+			memmove( buf, buf + used, len - used );
+			len -= used;
+		}
+		free( buf );
+	}
+
+	stats->seconds = stree_now() - start;
+	stats->mb_per_sec = stats->seconds > 0 ? stats->input_bytes / 1e6 / stats->seconds : 0;
+	return status < 0 ? 1 : 0;
+}
+
+/* Build the tree from a file, see stree_load_fd
+* Last modified:  10/18/2026
+*/
+
+int stree_load_file( SUFFIXTREE *tree, const char *path, int format,
+	unsigned int max_strings, unsigned long long max_bytes, STREE_LOAD_STATS *stats )
+{
+	int fd, ret;
+	if( ( fd = open( path, O_RDONLY ) ) < 0 )
+		return 1;
+	ret = stree_load_fd( tree, fd, format, max_strings, max_bytes, stats );
+	close( fd );
+	return ret;
+}
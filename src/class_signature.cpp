@@ -0,0 +1,426 @@
+#include "class_signature.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+
+#define STREE_SIG_NIL  0xFFFFFFFFu
+
+/* Prepare an empty membership table
+* Last modified: 10/18/2026
+*/
+
+void stree_classes_init( STREE_CLASSES *c )
+{
+	memset( ( void * )c, 0, sizeof( STREE_CLASSES ) );
+}
+
+/* Free a membership table
+* Last modified: 10/18/2026
+*/
+
+void stree_classes_free( STREE_CLASSES *c )
+{
+	free( c->row );
+	free( c->class_id );
+	free( c->weight );
+	free( c->class_size );
+	stree_classes_init( c );
+}
+
+/* Add a membership. The rows are filled in order: str_id may not
+* go down, and within a row class_id must go up. The strings
+* skipped get empty rows.
+* Parameter:  c:        the STREE_CLASSES
+*             str_id:   the string (1-based)
+*             class_id: the class
+*             weight:   the degree of membership, over 0
+* Return:     0 if successful, 1 if out of order or out of memory
+* Last modified: 10/18/2026
+*/
+
+int stree_classes_add( STREE_CLASSES *c, unsigned int str_id, unsigned int class_id, float weight )
+{
+	unsigned int size, k;
+	void *p;
+
+	if( str_id == 0 || str_id < c->strnum || !( weight > 0 ) ||
+		( str_id == c->strnum && c->nnz > 0 && c->row[str_id - 1] < c->nnz &&
+		c->class_id[c->nnz - 1] >= class_id ) )
+		return 1;
+	if( str_id + 1 > c->row_size ){
+		for( size = c->row_size == 0 ? 1024 : c->row_size; size < str_id + 1; size *= 2 );
+		if( ( p = realloc( c->row, sizeof( unsigned int ) * size ) ) == NULL )
+			return 1;
+		c->row = ( unsigned int * )p;
+		c->row_size = size;
+	}
+	if( c->nnz == c->nnz_size ){
+		size = c->nnz_size == 0 ? 1024 : 2 * c->nnz_size;
+		if( ( p = realloc( c->class_id, sizeof( unsigned int ) * size ) ) == NULL )
+			return 1;
+		c->class_id = ( unsigned int * )p;
+		if( ( p = realloc( c->weight, sizeof( float ) * size ) ) == NULL )
+			return 1;
+		c->weight = ( float * )p;
+		c->nnz_size = size;
+	}
+	if( class_id >= c->class_room ){
+		for( size = c->class_room == 0 ? 16 : c->class_room; size <= class_id; size *= 2 );
+		if( ( p = realloc( c->class_size, sizeof( double ) * size ) ) == NULL )
+			return 1;
+		c->class_size = ( double * )p;
+		for( k = c->class_room; k < size; k++ )
+			c->class_size[k] = 0;
+		c->class_room = size;
+	}
+	if( c->strnum == 0 )
+		c->row[0] = 0;
+	for( ; c->strnum < str_id; c->strnum++ )
+		c->row[c->strnum + 1] = c->row[c->strnum];
+	c->class_id[c->nnz] = class_id;
+	c->weight[c->nnz] = weight;
+	c->row[str_id] = ++c->nnz;
+	c->class_size[class_id] += weight;
+	if( class_id >= c->nclass )
+		c->nclass = class_id + 1;
+	return 0;
+}
+
+/* Fill a table with a partition into classes of consecutive IDs:
+* the first idclass[0] strings are class 0, the next idclass[1]
+* class 1, and so on
+* Parameter:  c:       the STREE_CLASSES, empty
+*             idclass: the size of each class
+*             nclass:  the number of classes
+*             strnum:  the number of strings
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_classes_from_sizes( STREE_CLASSES *c, const int *idclass, unsigned int nclass,
+	unsigned int strnum )
+{
+	unsigned int k, i, id;
+	for( k = 0, id = 1; k < nclass && id <= strnum; k++ ){
+		for( i = 0; ( int )i < idclass[k] && id <= strnum; i++ ){
+			if( stree_classes_add( c, id++, k, 1 ) )
+				return 1;
+		}
+	}
+	return 0;
+}
+
+/* The memberships of a string
+* Parameter:  c:        the STREE_CLASSES
+*             str_id:   the string
+*             class_id: its classes, in increasing order (for return)
+*             weight:   their weights (for return)
+* Return:     the number of classes of the string
+* Last modified: 10/18/2026
+*/
+
+unsigned int stree_classes_row( const STREE_CLASSES *c, unsigned int str_id,
+	const unsigned int **class_id, const float **weight )
+{
+	if( str_id == 0 || str_id > c->strnum ){
+		*class_id = NULL;
+		*weight = NULL;
+		return 0;
+	}
+	*class_id = c->class_id + c->row[str_id - 1];
+	*weight = c->weight + c->row[str_id - 1];
+	return c->row[str_id] - c->row[str_id - 1];
+}
+
+/* The weight of a string in a class, 0 if not a member
+* Last modified: 10/18/2026
+*/
+
+float stree_classes_weight( const STREE_CLASSES *c, unsigned int str_id, unsigned int class_id )
+{
+	const unsigned int *id, *k;
+	const float *w;
+	unsigned int n;
+
+	n = stree_classes_row( c, str_id, &id, &w );
+	k = lower_bound( id, id + n, class_id );
+	return k != id + n && *k == class_id ? w[k - id] : 0;
+}
+
+typedef vector< pair< unsigned int, double > > STREE_CLASS_COUNT;     /*(class, support), by class*/
+
+/* An open node of the walk */
+typedef struct stree_sig_frame{
+	unsigned int entry;         /*the visiting order of the node*/
+	NODE *node;
+	CHILD_STRUCT *next;         /*the next child to visit*/
+	int below;                  /*a node below was reported*/
+	STREE_CLASS_COUNT count;
+}STREE_SIG_FRAME;
+
+/* The state shared by the workers */
+typedef struct stree_sig_job{
+	SUFFIXTREE *tree;
+	const STREE_CLASSES *classes;
+	double min_support;
+	int mode;
+	vector< NODE * > task;                      /*the subtrees of the root*/
+	vector< vector< STREE_SIGNATURE > > out;    /*the records of each task*/
+	unsigned int next_task;
+	STREE_SIG_FN fn;            /*called at once by a single worker, else NULL*/
+	void *arg;
+	int stop;
+}STREE_SIG_JOB;
+
+typedef struct stree_sig_worker{
+	STREE_SIG_JOB *job;
+	vector< STREE_SIG_FRAME > stack;    /*frames past top are kept for their lists*/
+	unsigned int top;
+	vector< unsigned int > last;        /*the entry of the last leaf of each string*/
+	vector< double > dense;             /*the supports of one leaf*/
+	vector< unsigned int > touched;
+	STREE_CLASS_COUNT merged;
+	unsigned int entry;
+}STREE_SIG_WORKER;
+
+/* Open a frame for node, counting the strings of a leaf */
+static void stree_sig_open( STREE_SIG_WORKER *w, NODE *node )
+{
+	STREE_SIG_JOB *job = w->job;
+	STREE_SIG_FRAME *f;
+	STRINGID s;
+	const unsigned int *cls;
+	const float *wt;
+	unsigned int pos, c, k, n, lo, hi, mid;
+
+	if( w->top == w->stack.size() )
+		w->stack.resize( w->top + 1 );
+	f = &w->stack[w->top++];
+	f->entry = w->entry++;
+	f->node = node;
+	f->next = node->children;
+	f->below = 0;
+	f->count.clear();
+	if( node->node_type == INTERNODE )
+		return;
+	for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); ){
+		if( ( n = stree_classes_row( job->classes, s.str_id, &cls, &wt ) ) == 0 )
+			continue;
+		for( k = 0; k < n; k++ ){
+			if( w->dense[cls[k]] == 0 )
+				w->touched.push_back( cls[k] );
+			w->dense[cls[k]] += wt[k];
+		}
+		if( w->last[s.str_id] != STREE_SIG_NIL ){
+			/* a repeat: take it off at the lowest common ancestor */
+			for( lo = 0, hi = w->top - 1; hi - lo > 1; ){
+				mid = ( lo + hi ) / 2;
+				if( w->stack[mid].entry <= w->last[s.str_id] )
+					lo = mid;
+				else
+					hi = mid;
+			}
+			if( w->stack[lo].entry <= w->last[s.str_id] ){
+				STREE_CLASS_COUNT &lca = w->stack[lo].count;
+				for( k = 0, c = 0; k < n; k++ ){
+					for( ; lca[c].first < cls[k]; c++ );
+					lca[c].second -= wt[k];
+				}
+			}
+		}
+		w->last[s.str_id] = f->entry;
+	}
+	sort( w->touched.begin(), w->touched.end() );
+	for( k = 0; k < w->touched.size(); k++ ){
+		f->count.push_back( make_pair( w->touched[k], w->dense[w->touched[k]] ) );
+		w->dense[w->touched[k]] = 0;
+	}
+	w->touched.clear();
+}
+
+/* Report the node of a closing frame if it is a signature
+* Return:     1 if reported, 0 otherwise
+*/
+static int stree_sig_check( STREE_SIG_WORKER *w, STREE_SIG_FRAME *f, unsigned int task )
+{
+	STREE_SIG_JOB *job = w->job;
+	const STREE_CLASSES *cl = job->classes;
+	STREE_SIGNATURE sig;
+	unsigned int k, best, zero;
+	double r, max, second;
+
+	if( f->node->parent == f->node || EMPTY_EDGE( f->node ) )
+		return 0;
+	if( job->mode == STREE_SIG_DEEPEST && f->below )
+		return 0;
+	/* the classes left out of the list have ratio 0 */
+	max = second = -1;
+	best = 0;
+	for( k = 0, zero = cl->nclass; k < f->count.size(); k++ ){
+		if( !( f->count[k].second > 0 ) )
+			continue;
+		zero--;
+		r = f->count[k].second / cl->class_size[f->count[k].first];
+		if( r > max ){
+			second = max;
+			max = r;
+			best = k;
+		}
+		else if( r > second )
+			second = r;
+	}
+	if( max < 0 || f->count[best].second < job->min_support )
+		return 0;
+	if( zero > 0 && second < 0 )
+		second = 0;
+	sig.class_id = f->count[best].first;
+	sig.node = f->node;
+	sig.length = NODE_DEPTH( job->tree, f->node );
+	sig.support = f->count[best].second;
+	sig.ratio = max;
+	sig.runner_up = second < 0 ? 0 : second;
+	if( job->fn != NULL ){
+		if( job->fn( job->arg, &sig ) )
+			job->stop = 1;
+	}
+	else
+		job->out[task].push_back( sig );
+	return 1;
+}
+
+/* Close the top frame, folding its list into the parent's */
+static void stree_sig_close( STREE_SIG_WORKER *w, unsigned int task )
+{
+	STREE_SIG_FRAME *f, *p;
+	int reported;
+
+	f = &w->stack[--w->top];
+	reported = stree_sig_check( w, f, task );
+	if( w->top == 0 )
+		return;
+	p = &w->stack[w->top - 1];
+	p->below |= reported | f->below;
+	w->merged.clear();
+	w->merged.reserve( p->count.size() + f->count.size() );
+	STREE_CLASS_COUNT::iterator a = p->count.begin(), b = f->count.begin();
+	while( a != p->count.end() || b != f->count.end() ){
+		if( b == f->count.end() || ( a != p->count.end() && a->first < b->first ) )
+			w->merged.push_back( *a++ );
+		else if( a == p->count.end() || b->first < a->first )
+			w->merged.push_back( *b++ );
+		else{
+			w->merged.push_back( make_pair( a->first, a->second + b->second ) );
+			a++;
+			b++;
+		}
+	}
+	p->count.swap( w->merged );
+}
+
+/* Walk the subtrees of the root handed out to this worker */
+static void *stree_sig_run( void *arg )
+{
+	STREE_SIG_WORKER *w = ( STREE_SIG_WORKER * )arg;
+	STREE_SIG_JOB *job = w->job;
+	CHILD_STRUCT *c;
+	unsigned int task;
+
+	w->last.assign( job->tree->strnum + 1, STREE_SIG_NIL );
+	w->dense.assign( job->classes->nclass, 0 );
+	w->top = 0;
+	w->entry = 0;
+	while( !job->stop && ( task = __atomic_fetch_add( &job->next_task, 1, __ATOMIC_RELAXED ) ) < job->task.size() ){
+		/* a root frame, so the repeats of other subtrees find no ancestor */
+		w->top = 0;
+		stree_sig_open( w, job->tree->root );
+		w->stack[0].next = NULL;
+		stree_sig_open( w, job->task[task] );
+		while( w->top > 1 && !job->stop ){
+			if( ( c = w->stack[w->top - 1].next ) != NULL ){
+				w->stack[w->top - 1].next = c->next;
+				stree_sig_open( w, c->child );
+			}
+			else
+				stree_sig_close( w, task );
+		}
+	}
+	return NULL;
+}
+
+/* Find the signature substrings of the classes
+* Parameter:  tree:        the SUFFIXTREE
+*             classes:     the memberships of its strings
+*             min_support: the least support of a signature in its
+*                          class
+*             mode:        STREE_SIG_ALL, or STREE_SIG_DEEPEST for
+*                          only the signatures without one below
+*             threads:     the number of threads, 0 for one per CPU
+*             fn, arg:     the sink, called for each signature; it
+*                          stops the mining by returning non-zero
+* Return:     0 if successful, 1 if stopped by the sink or there
+*             is no class
+* Last modified: 10/18/2026
+*/
+
+int stree_signatures( SUFFIXTREE *tree, const STREE_CLASSES *classes, double min_support,
+	int mode, int threads, STREE_SIG_FN fn, void *arg )
+{
+	STREE_SIG_JOB job;
+	vector< STREE_SIG_WORKER > worker;
+	pthread_t *thread;
+	int *started;
+	CHILD_STRUCT *c;
+	unsigned int i, k;
+
+	if( tree->root == NULL || classes->nclass == 0 )
+		return 1;
+	job.tree = tree;
+	job.classes = classes;
+	job.min_support = min_support;
+	job.mode = mode;
+	for( c = tree->root->children; c != NULL; c = c->next ){
+		if( !EMPTY_EDGE( c->child ) )
+			job.task.push_back( c->child );
+	}
+	job.next_task = 0;
+	job.stop = 0;
+	job.arg = arg;
+	if( threads <= 0 )
+		threads = ( int )sysconf( _SC_NPROCESSORS_ONLN );
+	if( ( unsigned int )threads > job.task.size() )
+		threads = job.task.size();
+	if( threads < 1 )
+		threads = 1;
+	job.fn = threads == 1 ? fn : NULL;
+	job.out.resize( job.task.size() );
+
+	worker.resize( threads );
+	thread = ( pthread_t * )malloc( sizeof( pthread_t ) * threads );
+	started = ( int * )calloc( threads, sizeof( int ) );
+	for( i = 0; ( int )i < threads; i++ )
+		worker[i].job = &job;
+	for( i = 1; ( int )i < threads; i++ ){
+		if( thread != NULL && started != NULL )
+			started[i] = pthread_create( &thread[i], NULL, stree_sig_run, &worker[i] ) == 0;
+	}
+	stree_sig_run( &worker[0] );
+	for( i = 1; ( int )i < threads; i++ ){
+		if( started != NULL && started[i] )
+			pthread_join( thread[i], NULL );
+	}
+	free( thread );
+	free( started );
+
+	/* the records of each subtree, in order */
+	if( job.fn == NULL ){
+		for( k = 0; k < job.out.size() && !job.stop; k++ ){
+			for( i = 0; i < job.out[k].size(); i++ ){
+				if( fn( arg, &job.out[k][i] ) ){
+					job.stop = 1;
+					break;
+				}
+			}
+		}
+	}
+	return job.stop;
+}
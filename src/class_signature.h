@@ -0,0 +1,63 @@
+#pragma once
+
+#include "suffix_tree.h"
+
+/* Class signature substrings.
+*
+* Each string belongs to some classes, each with a weight: 1 for a
+* plain partition, a degree of membership for fuzzy classes. The
+* memberships are kept as sparse rows, one for each string ID, so
+* they take memory for the memberships that exist only. The support
+* of a substring in a class is the weight of the strings of the
+* class that have it, and a substring is a signature of the class in
+* which its support is the largest part of the class, when that
+* support is min_support or more.
+*
+* The supports under every node are counted from the leaves alone,
+* as in stree_count_strings: each open node of the depth-first walk
+* keeps a sparse (class, support) list that is folded into its
+* parent's when it closes. The subtrees of the root are walked in
+* parallel, and the records passed to a sink in depth-first order,
+* each node after its subtree.
+*/
+
+/* Class memberships: the classes of string i (1-based) are
+* class_id[row[i-1]] to class_id[row[i]-1], in increasing order */
+typedef struct stree_classes{
+	unsigned int strnum;        /*the last string ID with a row*/
+	unsigned int nclass;        /*class IDs are below nclass*/
+	unsigned int *row;
+	unsigned int *class_id;
+	float *weight;
+	double *class_size;         /*the weight of each class*/
+	unsigned int nnz;           /*the memberships*/
+	unsigned int row_size;
+	unsigned int nnz_size;
+	unsigned int class_room;
+}STREE_CLASSES;
+
+#define STREE_SIG_ALL      0    /*every node that qualifies*/
+#define STREE_SIG_DEEPEST  1    /*only the nodes with none below*/
+
+typedef struct stree_signature{
+	unsigned int class_id;
+	NODE *node;                 /*get_substring( tree, node ) gives the substring*/
+	unsigned int length;
+	double support;             /*the weight of the strings of the class with it*/
+	double ratio;               /*support over the size of the class*/
+	double runner_up;           /*the next best ratio of another class*/
+}STREE_SIGNATURE;
+
+typedef int ( *STREE_SIG_FN )( void *arg, const STREE_SIGNATURE *sig );
+
+void stree_classes_init( STREE_CLASSES *c );
+void stree_classes_free( STREE_CLASSES *c );
+int stree_classes_add( STREE_CLASSES *c, unsigned int str_id, unsigned int class_id, float weight );
+int stree_classes_from_sizes( STREE_CLASSES *c, const int *idclass, unsigned int nclass,
+	unsigned int strnum );
+unsigned int stree_classes_row( const STREE_CLASSES *c, unsigned int str_id,
+	const unsigned int **class_id, const float **weight );
+float stree_classes_weight( const STREE_CLASSES *c, unsigned int str_id, unsigned int class_id );
+
+int stree_signatures( SUFFIXTREE *tree, const STREE_CLASSES *classes, double min_support,
+	int mode, int threads, STREE_SIG_FN fn, void *arg );
@@ -0,0 +1,872 @@
+#include "compact_tree.h"
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static bool nodeindex_less( const pair<NODE*, unsigned int> &a, const pair<NODE*, unsigned int> &b )
+{
+	return a.first < b.first;
+}
+
+static unsigned char ctree_first_char( NODE *node )
+{
+	return node->start_char == NULL || node->edgelen == 0 ? 0 : ( unsigned char )node->start_char[0];
+}
+
+static bool child_less( NODE *a, NODE *b )
+{
+	return ctree_first_char( a ) < ctree_first_char( b );
+}
+
+static unsigned int ctree_uf_find( vector<unsigned int> &uf, unsigned int i )
+{
+	while( uf[i] != i ){
+		uf[i] = uf[uf[i]];
+		i = uf[i];
+	}
+	return i;
+}
+
+/* Set the string count of a node whose subtree is done and fold
+* its repeats into the parent, which stays open */
+static void ctree_close_node( COMPACTTREE *c, unsigned int i, vector<unsigned int> &uf, vector<unsigned int> &dup )
+{
+	c->string_count[i] = c->occ_end[i] - c->occ_begin[i] - dup[i];
+	if( i != 0 ){
+		dup[c->parent[i]] += dup[i];
+		uf[i] = c->parent[i];
+	}
+}
+
+/* The left character shared by the occurrences occ[from] ..
+* occ[to-1], CTREE_LEFT_MIXED if none is */
+static unsigned int ctree_range_left( const COMPACTTREE *c, unsigned int from, unsigned int to )
+{
+	if( from == to || c->left_next[from] < to )
+		return CTREE_LEFT_MIXED;
+	return ctree_left_char( c, from );
+}
+
+/* left_next[k], from left_next[k+1] */
+static unsigned int ctree_left_next( const COMPACTTREE *c, unsigned int k )
+{
+	return k + 1 == c->occ_count || ctree_left_char( c, k + 1 ) != ctree_left_char( c, k ) ?
+		k + 1 : c->left_next[k+1];
+}
+
+/* side_char[i], from left_next */
+static unsigned int ctree_side_char( const COMPACTTREE *c, unsigned int i )
+{
+	unsigned int u, a, b;
+	u = c->parent[i];
+	a = ctree_range_left( c, c->occ_begin[u], c->occ_begin[i] );
+	b = ctree_range_left( c, c->occ_end[i], c->occ_end[u] );
+	if( c->occ_begin[u] == c->occ_begin[i] )
+		a = b;
+	else if( c->occ_end[i] == c->occ_end[u] )
+		b = a;
+	return a == b ? a : CTREE_LEFT_MIXED;
+}
+
+/* side_up[i], from side_char and side_up of the nodes above */
+static unsigned int ctree_side_up( const COMPACTTREE *c, unsigned int i )
+{
+	unsigned int u = c->parent[i];
+	return u != 0 && c->side_char[u] == c->side_char[i] ? c->side_up[u] : u;
+}
+
+/* Fill left_next, side_char and side_up, the left characters read
+* by MEM reporting; the nodes are taken in index order, parents first
+* Return:     0 if successful, 1 otherwise
+*/
+static int ctree_build_left( COMPACTTREE *c )
+{
+	unsigned int i, k, n = c->node_count;
+
+	if( ( c->left_next = ( unsigned int * )malloc( sizeof( unsigned int ) * ( c->occ_count + 1 ) ) ) == NULL ||
+		( c->side_char = ( unsigned short * )malloc( sizeof( unsigned short ) * n ) ) == NULL ||
+		( c->side_up = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL )
+		return 1;
+	c->left_next[c->occ_count] = c->occ_count;
+	for( k = c->occ_count; k-- > 0; )
+		c->left_next[k] = ctree_left_next( c, k );
+	c->side_char[0] = CTREE_LEFT_MIXED;
+	c->side_up[0] = 0;
+	for( i = 1; i < n; i++ ){
+		c->side_char[i] = ctree_side_char( c, i );
+		c->side_up[i] = ctree_side_up( c, i );
+	}
+	return 0;
+}
+
+/* Build the compact form of a tree. The SUFFIXTREE is not
+* modified and may be destroyed afterwards. Of a sliding window,
+* only the live strings are kept, numbered from 1 as after
+* stree_window_compact. Not while a string is open in an
+* STREE_BUILDER.
+* Parameter:  c:    the COMPACTTREE to fill
+*             tree: the built SUFFIXTREE
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_build( COMPACTTREE *c, SUFFIXTREE *tree )
+{
+	vector<NODE*> order, kids;
+	vector< pair<NODE*, unsigned int> > index;
+	vector<unsigned int> stack, uf, dup, last;
+	CHILD_STRUCT *ch;
+	STRINGID s;
+	NODE *node;
+	unsigned int i, k, n, next, pos, evicted, dead;
+	OCCURRENCE *o;
+
+	memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+	if( tree->strnum == tree->str_evicted || tree->root == NULL ||
+		tree->str_offset[tree->strnum] != tree->text_len )
+		return 1;
+
+	/* the edge offsets of both forms refer to the same text, less
+	that of the evicted strings */
+	evicted = tree->str_evicted;
+	dead = tree->str_offset[evicted];
+	c->strnum = tree->strnum - evicted;
+	c->text_len = tree->text_len - dead;
+	if( ( c->text = ( char * )malloc( c->text_len ) ) == NULL ||
+		( c->str_offset = ( unsigned int * )malloc( sizeof( unsigned int ) * ( c->strnum + 1 ) ) ) == NULL ){
+		ctree_free( c );
+		return 1;
+	}
+	memcpy( c->text, tree->text + dead, c->text_len );
+	for( i = 0; i <= c->strnum; i++ )
+		c->str_offset[i] = tree->str_offset[i + evicted] - dead;
+
+	/* number the nodes breadth first, children sorted by first character */
+	order.push_back( tree->root );
+	for( i = 0; i < order.size(); i++ ){
+		kids.clear();
+		for( ch = order[i]->children; ch != NULL; ch = ch->next )
+			kids.push_back( ch->child );
+		stable_sort( kids.begin(), kids.end(), child_less );
+		order.insert( order.end(), kids.begin(), kids.end() );
+	}
+	n = c->node_count = order.size();
+	for( i = 0; i < n; i++ )
+		index.push_back( make_pair( order[i], i ) );
+	sort( index.begin(), index.end(), nodeindex_less );
+
+	if( ( c->nodes = ( CNODE * )malloc( sizeof( CNODE ) * ( n + 1 ) ) ) == NULL ||
+		( c->first_char = ( unsigned char * )malloc( n + 1 ) ) == NULL ||
+		( c->parent = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL ||
+		( c->char_depth = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL ||
+		( c->occ_begin = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL ||
+		( c->occ_end = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL ||
+		( c->string_count = ( unsigned int * )malloc( sizeof( unsigned int ) * n ) ) == NULL ){
+		ctree_free( c );
+		return 1;
+	}
+
+	for( i = 0, next = 1; i < n; i++ ){
+		node = order[i];
+		c->nodes[i].edge_len = node->start_char == NULL ? 0 : node->edgelen;
+		c->nodes[i].edge_start = c->nodes[i].edge_len == 0 || evicted > 0 ? 0 : ( unsigned int )( node->start_char - tree->text );
+		c->nodes[i].first_child = next;
+		c->first_char[i] = ctree_first_char( node );
+		c->char_depth[i] = node->char_depth;
+		c->parent[i] = 0;
+		c->nodes[i].suffix_link = CTREE_NIL;
+		if( node->node_type == INTERNODE && node->suffix_link != NULL ){
+			c->nodes[i].suffix_link = lower_bound( index.begin(), index.end(),
+				make_pair( node->suffix_link, 0u ), nodeindex_less )->second;
+		}
+		for( ch = node->children; ch != NULL; ch = ch->next )
+			next++;
+	}
+	c->nodes[n].edge_start = c->nodes[n].edge_len = 0;
+	c->nodes[n].first_child = n;
+	c->nodes[n].suffix_link = CTREE_NIL;
+	c->first_char[n] = 0;
+	for( i = 0; i < n; i++ ){
+		for( k = c->nodes[i].first_child; k < c->nodes[i+1].first_child; k++ )
+			c->parent[k] = i;
+	}
+
+	/* collect the suffixes of the leaves depth first, so that
+	each subtree covers a contiguous range of them. A string seen
+	again is counted off at the lowest common ancestor of its two
+	leaves, the deepest open node over the earlier one. */
+	for( i = 0, k = 0; i < n; i++ ){
+		if( order[i]->node_type != INTERNODE )
+			k += order[i]->strings.count;
+	}
+	c->occ_count = k;
+	if( ( c->occ = ( OCCURRENCE * )malloc( sizeof( OCCURRENCE ) * ( k + 1 ) ) ) == NULL ){
+		ctree_free( c );
+		return 1;
+	}
+	uf.resize( n );
+	dup.assign( n, 0 );
+	last.assign( c->strnum + 1, CTREE_NIL );
+	stack.push_back( 0 );
+	k = 0;
+	while( !stack.empty() ){
+		i = stack.back();
+		stack.pop_back();
+		if( i & 0x80000000u ){
+			/* all the children of the node are done */
+			i &= 0x7FFFFFFFu;
+			c->occ_end[i] = k;
+			ctree_close_node( c, i, uf, dup );
+			continue;
+		}
+		c->occ_begin[i] = k;
+		uf[i] = i;
+		if( order[i]->node_type != INTERNODE ){
+			for( pos = 0; stree_posting_next( &order[i]->strings, &pos, &s ); k++ ){
+				c->occ[k].str_id = s.str_id - evicted;
+				c->occ[k].str_start = s.str_start;
+				if( last[s.str_id - evicted] != CTREE_NIL )
+					dup[ctree_uf_find( uf, last[s.str_id - evicted] )]++;
+				last[s.str_id - evicted] = i;
+			}
+			c->occ_end[i] = k;
+			ctree_close_node( c, i, uf, dup );
+			continue;
+		}
+		stack.push_back( i | 0x80000000u );
+		for( next = c->nodes[i+1].first_child; next > c->nodes[i].first_child; next-- )
+			stack.push_back( next - 1 );
+	}
+
+	/* labels in evicted text are moved to an occurrence of the path */
+	for( i = 0; evicted > 0 && i < n; i++ ){
+		if( c->nodes[i].edge_len == 0 )
+			continue;
+		o = &c->occ[c->occ_begin[i]];
+		c->nodes[i].edge_start = c->str_offset[o->str_id - 1] + o->str_start + c->char_depth[i] - c->nodes[i].edge_len;
+	}
+	if( ctree_build_left( c ) ){
+		ctree_free( c );
+		return 1;
+	}
+	return 0;
+}
+
+/* Free the arrays of a COMPACTTREE
+* Last modified:  10/18/2026
+*/
+
+void ctree_free( COMPACTTREE *c )
+{
+	if( c->map != NULL ){
+		/* the arrays belong to the mapped snapshot */
+		munmap( c->map, c->map_size );
+		memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+		return;
+	}
+	free( c->text );
+	free( c->str_offset );
+	free( c->nodes );
+	free( c->first_char );
+	free( c->parent );
+	free( c->char_depth );
+	free( c->occ_begin );
+	free( c->occ_end );
+	free( c->string_count );
+	free( c->occ );
+	free( c->left_next );
+	free( c->side_char );
+	free( c->side_up );
+	memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+}
+
+/* Return the number of bytes held by the compact tree
+* Last modified:  10/18/2026
+*/
+
+size_t ctree_memory_usage( const COMPACTTREE *c )
+{
+	size_t n = c->node_count;
+	return c->text_len + sizeof( unsigned int ) * ( c->strnum + 1 )
+		+ ( sizeof( CNODE ) + 1 ) * ( n + 1 ) + ( sizeof( unsigned int ) * 6 + sizeof( unsigned short ) ) * n
+		+ ( sizeof( OCCURRENCE ) + sizeof( unsigned int ) ) * ( c->occ_count + 1 );
+}
+
+/* Get the child of node whose edge starts with ch
+* Parameter:  c:    the COMPACTTREE
+*             node: the parent node
+*             ch:   the starting character
+* Return:     the index of the child, CTREE_NIL if none
+* Last modified:  10/18/2026
+*/
+
+unsigned int ctree_get_child( const COMPACTTREE *c, unsigned int node, char ch )
+{
+	unsigned int lo, hi, mid;
+	unsigned char key = ( unsigned char )ch;
+
+	lo = c->nodes[node].first_child;
+	hi = c->nodes[node+1].first_child;
+	if( hi - lo <= 8 ){
+		for( ; lo < hi; lo++ ){
+			if( c->first_char[lo] == key )
+				return lo;
+		}
+		return CTREE_NIL;
+	}
+	while( lo < hi ){
+		mid = ( lo + hi ) / 2;
+		if( c->first_char[mid] < key )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < c->nodes[node+1].first_child && c->first_char[lo] == key ? lo : CTREE_NIL;
+}
+
+/* walk down the path from the root according to the string,
+* comparing a whole edge label at a time
+* Parameter:  c:       the COMPACTTREE
+*             string:  the query string
+*             len:     the number of characters to walk
+*             edgepos: the number of characters matched on the
+*                      edge of the returned node (for return)
+* Return:     the node on whose edge the walk ends,
+*             CTREE_NIL if the string does not occur
+* Last modified:  10/18/2026
+*/
+
+unsigned int ctree_walk_down( const COMPACTTREE *c, char *string, unsigned int len, unsigned int *edgepos )
+{
+	unsigned int node, i, k, n;
+	char *label;
+
+	node = 0;
+	*edgepos = 0;
+	for( i = 0; i < len; i += n ){
+		if( ( node = ctree_get_child( c, node, string[i] ) ) == CTREE_NIL )
+			return CTREE_NIL;
+		label = c->text + c->nodes[node].edge_start;
+		n = c->nodes[node].edge_len;
+		if( n > len - i )
+			n = len - i;
+		for( k = 1; k < n; k++ ){
+			if( label[k] != string[i+k] )
+				return CTREE_NIL;
+		}
+		*edgepos = n;
+	}
+	return node;
+}
+
+/* Count the occurrences of a pattern and the strings it occurs
+* in, in O(length of the pattern), from the ranges and counts kept
+* for every node
+* Parameter:  c:             the COMPACTTREE
+*             string:        the pattern
+*             len:           the length of the pattern
+*             embedding_num: the number of occurrences (for return)
+*             stringid_num:  the number of strings (for return)
+* Return:     0 if the pattern occurs, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_count_occurrences( const COMPACTTREE *c, char *string, unsigned int len,
+	unsigned int *embedding_num, unsigned int *stringid_num )
+{
+	unsigned int node, edgepos;
+	*embedding_num = *stringid_num = 0;
+	if( c->node_count == 0 || ( node = ctree_walk_down( c, string, len, &edgepos ) ) == CTREE_NIL )
+		return 1;
+	*embedding_num = c->occ_end[node] - c->occ_begin[node];
+	*stringid_num = c->string_count[node];
+	return 0;
+}
+
+/* The state of one of the walks of a batch query */
+typedef struct ctree_lane{
+	unsigned int next;          /*the next query, an index in the sorted batch*/
+	unsigned int end;
+	CTREE_QUERY *q;             /*the query being walked, NULL when done*/
+	unsigned int node;          /*the edge being matched*/
+	unsigned int depth;         /*the number of characters above it*/
+	unsigned int i;             /*the number of characters matched*/
+	int loaded;                 /*cur holds nodes[node]*/
+	CNODE cur;
+	vector< pair<unsigned int, unsigned int> > path;  /*(node, depth) of the edges taken*/
+}CTREE_LANE;
+
+/* Sort key of a query: its first 16 characters packed big-endian,
+* so most comparisons never touch the pattern itself */
+typedef struct ctree_query_key{
+	unsigned long long hi;
+	unsigned long long lo;
+	CTREE_QUERY *q;
+}CTREE_QUERY_KEY;
+
+static bool query_less( const CTREE_QUERY_KEY &a, const CTREE_QUERY_KEY &b )
+{
+	unsigned int len;
+	int r;
+	if( a.hi != b.hi )
+		return a.hi < b.hi;
+	if( a.lo != b.lo )
+		return a.lo < b.lo;
+	if( a.q->len <= 16 || b.q->len <= 16 )
+		return a.q->len < b.q->len;
+	len = a.q->len < b.q->len ? a.q->len : b.q->len;
+	r = memcmp( a.q->string + 16, b.q->string + 16, len - 16 );
+	return r != 0 ? r < 0 : a.q->len < b.q->len;
+}
+
+/* Record the result of the query of a lane */
+static void ctree_lane_finish( const COMPACTTREE *c, CTREE_LANE *l, int found )
+{
+	CTREE_QUERY *q = l->q;
+	q->node = found ? l->node : CTREE_NIL;
+	q->embedding_num = found ? c->occ_end[l->node] - c->occ_begin[l->node] : 0;
+	q->stringid_num = found ? c->string_count[l->node] : 0;
+}
+
+/* Move a lane to its next query. The query shares its longest
+* common prefix with the one before it in sorted order, so the
+* walk resumes on the edge of the path where that prefix ends.
+* Return:     1 if the lane has no query left, 0 otherwise
+*/
+static int ctree_lane_next( const COMPACTTREE *c, CTREE_LANE *l, vector<CTREE_QUERY*> &sorted )
+{
+	CTREE_QUERY *p, *q;
+	unsigned int lcp, lim;
+
+	for( ; ; ){
+		p = l->q;
+		if( l->next == l->end ){
+			l->q = NULL;
+			return 1;
+		}
+		q = l->q = sorted[l->next++];
+		lcp = 0;
+		if( p != NULL ){
+			/* l->i characters of p were matched */
+			lim = q->len < l->i ? q->len : l->i;
+			for( ; lcp < lim && p->string[lcp] == q->string[lcp]; lcp++ );
+			if( p->node == CTREE_NIL && lcp == l->i && q->len > lcp && q->string[lcp] == p->string[lcp] ){
+				/* it fails on the same character */
+				ctree_lane_finish( c, l, 0 );
+				continue;
+			}
+		}
+		while( !l->path.empty() && l->path.back().second >= lcp )
+			l->path.pop_back();
+		if( l->path.empty() ){
+			l->node = 0;
+			l->depth = 0;
+		}
+		else{
+			l->node = l->path.back().first;
+			l->depth = l->path.back().second;
+		}
+		l->i = lcp;
+		l->loaded = 0;
+		return 0;
+	}
+}
+
+/* Advance the walk of a lane by half an edge: read the node and
+* prefetch its label and children, or match the label and move to
+* the child, prefetching it for the next round
+* Return:     1 if the lane has no query left, 0 otherwise
+*/
+static int ctree_lane_step( const COMPACTTREE *c, CTREE_LANE *l, vector<CTREE_QUERY*> &sorted )
+{
+	CTREE_QUERY *q = l->q;
+	unsigned int end, child;
+	char *label;
+
+	if( !l->loaded ){
+		l->cur = c->nodes[l->node];
+		__builtin_prefetch( c->text + l->cur.edge_start + ( l->i - l->depth ) );
+		__builtin_prefetch( c->first_char + l->cur.first_child );
+		l->loaded = 1;
+		return 0;
+	}
+	end = l->depth + l->cur.edge_len;
+	label = c->text + l->cur.edge_start - l->depth;
+	for( ; l->i < q->len && l->i < end; l->i++ ){
+		if( label[l->i] != q->string[l->i] ){
+			ctree_lane_finish( c, l, 0 );
+			return ctree_lane_next( c, l, sorted );
+		}
+	}
+	if( l->i == q->len ){
+		ctree_lane_finish( c, l, 1 );
+		return ctree_lane_next( c, l, sorted );
+	}
+	if( ( child = ctree_get_child( c, l->node, q->string[l->i] ) ) == CTREE_NIL ){
+		ctree_lane_finish( c, l, 0 );
+		return ctree_lane_next( c, l, sorted );
+	}
+	l->path.push_back( make_pair( child, end ) );
+	l->node = child;
+	l->depth = end;
+	l->loaded = 0;
+	__builtin_prefetch( c->nodes + child );
+	__builtin_prefetch( c->nodes + child + 1 );
+	return 0;
+}
+
+/* Answer a batch of pattern queries. The patterns are sorted so
+* that neighbours share the walk of their common prefix, the sorted
+* batch is split among CTREE_BATCH_LANES walks, and the walks take
+* turns, each one prefetching what it reads next while the others
+* run. The result of each query is the same as a single walk.
+* Parameter:  c:   the COMPACTTREE
+*             q:   the queries, whose results are filled in
+*             num: the number of queries
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_query_batch( const COMPACTTREE *c, CTREE_QUERY *q, unsigned int num )
+{
+	vector<CTREE_QUERY_KEY> key( num );
+	vector<CTREE_QUERY*> sorted( num );
+	CTREE_LANE lane[CTREE_BATCH_LANES];
+	unsigned long long ch;
+	unsigned int i, k, active;
+
+	if( c->node_count == 0 )
+		return 1;
+	for( i = 0; i < num; i++ ){
+		key[i].hi = key[i].lo = 0;
+		key[i].q = &q[i];
+		for( k = 0; k < 16 && k < q[i].len; k++ ){
+			ch = ( unsigned char )q[i].string[k];
+			if( k < 8 )
+				key[i].hi |= ch << ( 56 - 8 * k );
+			else
+				key[i].lo |= ch << ( 120 - 8 * k );
+		}
+	}
+	sort( key.begin(), key.end(), query_less );
+	for( i = 0; i < num; i++ )
+		sorted[i] = key[i].q;
+	for( i = 0, active = 0; i < CTREE_BATCH_LANES; i++ ){
+		lane[i].next = ( unsigned int )( ( unsigned long long )num * i / CTREE_BATCH_LANES );
+		lane[i].end = ( unsigned int )( ( unsigned long long )num * ( i + 1 ) / CTREE_BATCH_LANES );
+		lane[i].q = NULL;
+		lane[i].i = 0;
+		if( !ctree_lane_next( c, &lane[i], sorted ) )
+			active++;
+	}
+	while( active > 0 ){
+		for( i = 0; i < CTREE_BATCH_LANES; i++ ){
+			if( lane[i].q != NULL && ctree_lane_step( c, &lane[i], sorted ) )
+				active--;
+		}
+	}
+	return 0;
+}
+
+/* Fill in the sizes of the snapshot arrays of a tree
+* Last modified:  10/18/2026
+*/
+
+static void ctree_array_sizes( const COMPACTTREE *c, unsigned long long *length )
+{
+	unsigned long long n = c->node_count;
+	length[CTREE_TEXT] = c->text_len;
+	length[CTREE_STR_OFFSET] = sizeof( unsigned int ) * ( c->strnum + 1ULL );
+	length[CTREE_NODES] = sizeof( CNODE ) * ( n + 1 );
+	length[CTREE_FIRST_CHAR] = n + 1;
+	length[CTREE_PARENT] = sizeof( unsigned int ) * n;
+	length[CTREE_CHAR_DEPTH] = sizeof( unsigned int ) * n;
+	length[CTREE_OCC_BEGIN] = sizeof( unsigned int ) * n;
+	length[CTREE_OCC_END] = sizeof( unsigned int ) * n;
+	length[CTREE_OCC] = sizeof( OCCURRENCE ) * ( c->occ_count + 1ULL );
+	length[CTREE_STRING_COUNT] = sizeof( unsigned int ) * n;
+	length[CTREE_LEFT_NEXT] = sizeof( unsigned int ) * ( c->occ_count + 1ULL );
+	length[CTREE_SIDE_CHAR] = sizeof( unsigned short ) * n;
+	length[CTREE_SIDE_UP] = sizeof( unsigned int ) * n;
+}
+
+/* Point at the snapshot arrays of a tree, in file order
+* Last modified:  10/18/2026
+*/
+
+static void ctree_arrays( const COMPACTTREE *c, void **array )
+{
+	array[CTREE_TEXT] = c->text;
+	array[CTREE_STR_OFFSET] = c->str_offset;
+	array[CTREE_NODES] = c->nodes;
+	array[CTREE_FIRST_CHAR] = c->first_char;
+	array[CTREE_PARENT] = c->parent;
+	array[CTREE_CHAR_DEPTH] = c->char_depth;
+	array[CTREE_OCC_BEGIN] = c->occ_begin;
+	array[CTREE_OCC_END] = c->occ_end;
+	array[CTREE_OCC] = c->occ;
+	array[CTREE_STRING_COUNT] = c->string_count;
+	array[CTREE_LEFT_NEXT] = c->left_next;
+	array[CTREE_SIDE_CHAR] = c->side_char;
+	array[CTREE_SIDE_UP] = c->side_up;
+}
+
+/* The checksum of the snapshot arrays, 8 bytes at a time
+* Last modified:  10/18/2026
+*/
+
+static unsigned long long ctree_checksum( void **array, const unsigned long long *length )
+{
+	unsigned long long h, w, k;
+	const unsigned char *p;
+	int i;
+
+	for( i = 0, h = CTREE_ARRAYS; i < CTREE_ARRAYS; i++ ){
+		p = ( const unsigned char * )array[i];
+		for( k = 0; k < length[i]; k += 8 ){
+			w = 0;
+			memcpy( &w, p + k, length[i] - k < 8 ? length[i] - k : 8 );
+			h = ( h ^ w ) * 0x9E3779B97F4A7C15ULL;
+			h ^= h >> 29;
+		}
+		h = ( h ^ length[i] ) * 0xBF58476D1CE4E5B9ULL;
+	}
+	return h;
+}
+
+/* Write a compact tree to a snapshot file
+* Parameter:  c:    the COMPACTTREE
+*             path: the file to write
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_save( const COMPACTTREE *c, const char *path )
+{
+	CTREE_HEADER h;
+	FILE *fp;
+	void *array[CTREE_ARRAYS];
+	char pad[64];
+	unsigned long long pos;
+	int i, ret;
+
+	memset( ( void * )&h, 0, sizeof( CTREE_HEADER ) );
+	memcpy( h.magic, CTREE_MAGIC, sizeof( h.magic ) );
+	h.version = CTREE_VERSION;
+	h.byte_order = CTREE_ORDER;
+	h.node_count = c->node_count;
+	h.strnum = c->strnum;
+	h.text_len = c->text_len;
+	h.occ_count = c->occ_count;
+	ctree_array_sizes( c, h.length );
+	ctree_arrays( c, array );
+	h.checksum = ctree_checksum( array, h.length );
+	for( i = 0, pos = sizeof( CTREE_HEADER ); i < CTREE_ARRAYS; i++ ){
+		pos = ( pos + 63 ) & ~63ULL;
+		h.offset[i] = pos;
+		pos += h.length[i];
+	}
+	h.file_size = pos;
+
+	if( ( fp = fopen( path, "wb" ) ) == NULL )
+		return 1;
+	memset( pad, 0, sizeof( pad ) );
+	ret = fwrite( &h, sizeof( CTREE_HEADER ), 1, fp ) != 1;
+	for( i = 0, pos = sizeof( CTREE_HEADER ); i < CTREE_ARRAYS && !ret; i++ ){
+		if( h.offset[i] > pos && fwrite( pad, h.offset[i] - pos, 1, fp ) != 1 )
+			ret = 1;
+		if( h.length[i] > 0 && fwrite( array[i], h.length[i], 1, fp ) != 1 )
+			ret = 1;
+		pos = h.offset[i] + h.length[i];
+	}
+	if( fclose( fp ) != 0 )
+		ret = 1;
+	return ret;
+}
+
+/* Check that every index in the arrays of a loaded tree is in
+* range and that the nodes form the tree ctree_build writes, so no
+* query reads outside the arrays of a corrupt file: the children of
+* each node follow it, the depths add up along the edges and drop
+* by one along the suffix links, the
+* occurrence ranges of the children split that of their parent, and
+* each occurrence lies in its string with room for the leaf's depth.
+* The left characters must be those ctree_build sets.
+* Return:     0 if the tree is sound, 1 otherwise
+*/
+
+static int ctree_check( const COMPACTTREE *c )
+{
+	unsigned int i, k, n, p, len;
+	const OCCURRENCE *o;
+
+	n = c->node_count;
+	if( n == 0 || c->str_offset[0] != 0 || c->str_offset[c->strnum] != c->text_len )
+		return 1;
+	for( i = 1; i <= c->strnum; i++ ){
+		if( c->str_offset[i] <= c->str_offset[i-1] || c->str_offset[i] > c->text_len ||
+			c->text[c->str_offset[i] - 1] != 0 )
+			return 1;
+	}
+	if( c->nodes[n].first_child != n || c->parent[0] != 0 || c->char_depth[0] != 0 ||
+		c->nodes[0].edge_len != 0 || c->occ_begin[0] != 0 || c->occ_end[0] != c->occ_count )
+		return 1;
+	for( i = 0; i < n; i++ ){
+		if( c->nodes[i].first_child <= i || c->nodes[i].first_child > c->nodes[i+1].first_child ||
+			( unsigned long long )c->nodes[i].edge_start + c->nodes[i].edge_len > c->text_len ||
+			( c->nodes[i].suffix_link != CTREE_NIL && ( c->nodes[i].suffix_link >= n ||
+			( i > 0 && c->char_depth[c->nodes[i].suffix_link] + 1 != c->char_depth[i] ) ) ) ||
+			c->first_char[i] != ( c->nodes[i].edge_len == 0 ? 0 : ( unsigned char )c->text[c->nodes[i].edge_start] ) ||
+			c->occ_begin[i] > c->occ_end[i] || c->occ_end[i] > c->occ_count )
+			return 1;
+		if( i > 0 ){
+			p = c->parent[i];
+			if( p >= i || i < c->nodes[p].first_child || i >= c->nodes[p+1].first_child ||
+				( unsigned long long )c->char_depth[p] + c->nodes[i].edge_len != c->char_depth[i] )
+				return 1;
+			if( c->occ_begin[i] != ( i == c->nodes[p].first_child ? c->occ_begin[p] : c->occ_end[i-1] ) ||
+				( i + 1 == c->nodes[p+1].first_child && c->occ_end[i] != c->occ_end[p] ) )
+				return 1;
+		}
+		if( c->nodes[i].first_child < c->nodes[i+1].first_child )
+			continue;
+		/* a leaf: its occurrences and their lengths */
+		for( k = c->occ_begin[i]; k < c->occ_end[i]; k++ ){
+			o = &c->occ[k];
+			if( o->str_id == 0 || o->str_id > c->strnum )
+				return 1;
+			len = c->str_offset[o->str_id] - c->str_offset[o->str_id - 1] - 1;
+			if( o->str_start > len || c->char_depth[i] > len - o->str_start )
+				return 1;
+		}
+	}
+	if( c->left_next[c->occ_count] != c->occ_count ||
+		c->side_char[0] != CTREE_LEFT_MIXED || c->side_up[0] != 0 )
+		return 1;
+	for( k = c->occ_count; k-- > 0; ){
+		if( c->left_next[k] != ctree_left_next( c, k ) )
+			return 1;
+	}
+	for( i = 1; i < n; i++ ){
+		if( c->side_char[i] != ctree_side_char( c, i ) || c->side_up[i] != ctree_side_up( c, i ) )
+			return 1;
+	}
+	return 0;
+}
+
+/* Map a snapshot file read-only and point a compact tree at it.
+* No array is copied or fixed up; the pages are shared with every
+* other process mapping the same file. ctree_free unmaps it. Only
+* the header is read: the arrays must lie inside the file, but their
+* contents are not checked, so a file that is not known to be good
+* should go through ctree_verify once.
+* Parameter:  c:    the COMPACTTREE to fill
+*             path: the snapshot file
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_load( COMPACTTREE *c, const char *path )
+{
+	CTREE_HEADER *h;
+	unsigned long long length[CTREE_ARRAYS];
+	struct stat st;
+	char *base;
+	void *map;
+	int fd, i;
+
+	memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+	if( ( fd = open( path, O_RDONLY ) ) < 0 )
+		return 1;
+	if( fstat( fd, &st ) != 0 || ( size_t )st.st_size < sizeof( CTREE_HEADER ) ){
+		close( fd );
+		return 1;
+	}
+	map = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	close( fd );
+	if( map == MAP_FAILED )
+		return 1;
+
+	h = ( CTREE_HEADER * )map;
+	base = ( char * )map;
+	c->node_count = h->node_count;
+	c->strnum = h->strnum;
+	c->text_len = h->text_len;
+	c->occ_count = h->occ_count;
+	ctree_array_sizes( c, length );
+	if( memcmp( h->magic, CTREE_MAGIC, sizeof( h->magic ) ) != 0 || h->version != CTREE_VERSION ||
+		h->byte_order != CTREE_ORDER || h->file_size != ( unsigned long long )st.st_size ){
+		munmap( map, st.st_size );
+		memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+		return 1;
+	}
+	for( i = 0; i < CTREE_ARRAYS; i++ ){
+		if( h->length[i] != length[i] || h->offset[i] % 64 != 0 || h->offset[i] > h->file_size ||
+			h->length[i] > h->file_size - h->offset[i] ){
+			munmap( map, st.st_size );
+			memset( ( void * )c, 0, sizeof( COMPACTTREE ) );
+			return 1;
+		}
+	}
+	c->text = base + h->offset[CTREE_TEXT];
+	c->str_offset = ( unsigned int * )( base + h->offset[CTREE_STR_OFFSET] );
+	c->nodes = ( CNODE * )( base + h->offset[CTREE_NODES] );
+	c->first_char = ( unsigned char * )( base + h->offset[CTREE_FIRST_CHAR] );
+	c->parent = ( unsigned int * )( base + h->offset[CTREE_PARENT] );
+	c->char_depth = ( unsigned int * )( base + h->offset[CTREE_CHAR_DEPTH] );
+	c->occ_begin = ( unsigned int * )( base + h->offset[CTREE_OCC_BEGIN] );
+	c->occ_end = ( unsigned int * )( base + h->offset[CTREE_OCC_END] );
+	c->occ = ( OCCURRENCE * )( base + h->offset[CTREE_OCC] );
+	c->string_count = ( unsigned int * )( base + h->offset[CTREE_STRING_COUNT] );
+	c->left_next = ( unsigned int * )( base + h->offset[CTREE_LEFT_NEXT] );
+	c->side_char = ( unsigned short * )( base + h->offset[CTREE_SIDE_CHAR] );
+	c->side_up = ( unsigned int * )( base + h->offset[CTREE_SIDE_UP] );
+	c->map = map;
+	c->map_size = st.st_size;
+	return 0;
+}
+
+/* Check a compact tree in full: the checksum of a loaded snapshot
+* against its header, then every index and range the queries follow.
+* This reads all the arrays, so run it once after a snapshot is
+* written or copied rather than at every load.
+* Parameter:  c: the COMPACTTREE, built or loaded
+* Return:     0 if the tree is sound, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int ctree_verify( const COMPACTTREE *c )
+{
+	const CTREE_HEADER *h;
+	unsigned long long length[CTREE_ARRAYS];
+	void *array[CTREE_ARRAYS];
+
+	if( c->map != NULL ){
+		h = ( const CTREE_HEADER * )c->map;
+		ctree_array_sizes( c, length );
+		ctree_arrays( c, array );
+		if( ctree_checksum( array, length ) != h->checksum )
+			return 1;
+	}
+	return ctree_check( c );
+}
+
+/* Save a built tree as a snapshot, to be loaded with ctree_load
+* Parameter:  tree: the SUFFIXTREE
+*             path: the file to write
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_save( SUFFIXTREE *tree, const char *path )
+{
+	COMPACTTREE c;
+	int ret;
+	if( ctree_build( &c, tree ) )
+		return 1;
+	ret = ctree_save( &c, path );
+	ctree_free( &c );
+	return ret;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "suffix_tree.h"
+
+/* Compact storage mode of a built SUFFIXTREE.
+*
+* Nodes live in one array addressed by 32-bit indices, in breadth
+* first order so that the children of a node are contiguous and
+* sorted by their first character: the children of node i are
+* [nodes[i].first_child, nodes[i+1].first_child). Node 0 is the
+* root. Edge labels are (offset, length) pairs into one shared text
+* buffer holding all the strings, each followed by a 0.
+*
+* The fields read on every step of a walk (CNODE and first_char)
+* take 17 bytes per node. Parent, depth, the leaf occurrences and
+* their counts are kept in separate arrays so they stay out of the
+* walk's cache lines.
+*
+* For the left-maximality tests of MEM reporting, the left character
+* of an occurrence is the one before it in the text, or
+* CTREE_LEFT_MIXED at the start of a string. left_next skips a run
+* of occurrences with the same left character. side_char[i] is the
+* left character shared by the occurrences under the parent of i
+* but not under i, CTREE_LEFT_MIXED if they have none in common, and
+* side_up[i] the first node above i whose side_char differs, so runs
+* of ancestors that all leave on the same character are passed at
+* once.
+*/
+
+#define CTREE_NIL 0xFFFFFFFFu
+#define CTREE_LEFT_MIXED 256
+
+typedef struct cnode{
+	unsigned int edge_start;    /*offset of the edge label in text*/
+	unsigned int edge_len;
+	unsigned int first_child;
+	unsigned int suffix_link;
+}CNODE;
+
+typedef struct occurrence{
+	unsigned int str_id;
+	unsigned int str_start;
+}OCCURRENCE;
+
+typedef struct compacttree{
+	unsigned int node_count;
+	unsigned int strnum;
+	unsigned int text_len;
+	char *text;
+	unsigned int *str_offset;   /*strnum+1 entries, string i starts at str_offset[i-1]*/
+	CNODE *nodes;               /*node_count+1 entries, the last one closes the child ranges*/
+	unsigned char *first_char;  /*first character of the edge, 0 for an empty edge*/
+	unsigned int *parent;
+	unsigned int *char_depth;
+	unsigned int *occ_begin;    /*the suffixes under node i are*/
+	unsigned int *occ_end;      /*occ[occ_begin[i]] .. occ[occ_end[i]-1]*/
+	unsigned int *string_count; /*the number of strings among them*/
+	OCCURRENCE *occ;
+	unsigned int occ_count;
+	unsigned int *left_next;    /*the next occurrence with another left character*/
+	unsigned short *side_char;
+	unsigned int *side_up;      /*0 (the root) if no node above differs*/
+	void *map;                  /*the snapshot the arrays point into, if loaded*/
+	size_t map_size;
+}COMPACTTREE;
+
+/* A pattern of a batch query, and its result: the locus, and the
+* occurrences c->occ[c->occ_begin[node]] .. on, as for a single walk.
+*/
+typedef struct ctree_query{
+	char *string;
+	unsigned int len;
+	unsigned int node;          /*the locus, CTREE_NIL if the pattern does not occur*/
+	unsigned int embedding_num;
+	unsigned int stringid_num;
+}CTREE_QUERY;
+
+#define CTREE_BATCH_LANES 16    /*walks interleaved by a batch query*/
+
+/* Snapshot file: a CTREE_HEADER followed by the arrays of a
+* COMPACTTREE, each starting on a 64-byte boundary. All the links
+* are indices, so the file is used in place once mapped. The
+* checksum covers the arrays and is checked by ctree_verify.
+*/
+#define CTREE_MAGIC    "STREECT"
+#define CTREE_VERSION  4
+#define CTREE_ORDER    0x01020304u
+
+#define CTREE_TEXT        0
+#define CTREE_STR_OFFSET  1
+#define CTREE_NODES       2
+#define CTREE_FIRST_CHAR  3
+#define CTREE_PARENT      4
+#define CTREE_CHAR_DEPTH  5
+#define CTREE_OCC_BEGIN   6
+#define CTREE_OCC_END     7
+#define CTREE_OCC         8
+#define CTREE_STRING_COUNT 9
+#define CTREE_LEFT_NEXT   10
+#define CTREE_SIDE_CHAR   11
+#define CTREE_SIDE_UP     12
+#define CTREE_ARRAYS      13
+
+typedef struct ctree_header{
+	char magic[8];
+	unsigned int version;
+	unsigned int byte_order;
+	unsigned int node_count;
+	unsigned int strnum;
+	unsigned int text_len;
+	unsigned int occ_count;
+	unsigned long long file_size;
+	unsigned long long checksum;
+	unsigned long long offset[CTREE_ARRAYS];
+	unsigned long long length[CTREE_ARRAYS];
+}CTREE_HEADER;
+
+/* The left character of occurrence k */
+inline unsigned int ctree_left_char( const COMPACTTREE *c, unsigned int k )
+{
+	const OCCURRENCE *o = &c->occ[k];
+	return o->str_start == 0 ? CTREE_LEFT_MIXED :
+		( unsigned char )c->text[c->str_offset[o->str_id - 1] + o->str_start - 1];
+}
+
+int ctree_build( COMPACTTREE *c, SUFFIXTREE *tree );
+void ctree_free( COMPACTTREE *c );
+size_t ctree_memory_usage( const COMPACTTREE *c );
+unsigned int ctree_get_child( const COMPACTTREE *c, unsigned int node, char ch );
+unsigned int ctree_walk_down( const COMPACTTREE *c, char *string, unsigned int len, unsigned int *edgepos );
+int ctree_count_occurrences( const COMPACTTREE *c, char *string, unsigned int len,
+	unsigned int *embedding_num, unsigned int *stringid_num );
+int ctree_query_batch( const COMPACTTREE *c, CTREE_QUERY *q, unsigned int num );
+int ctree_save( const COMPACTTREE *c, const char *path );
+int ctree_load( COMPACTTREE *c, const char *path );
+int ctree_verify( const COMPACTTREE *c );
+int stree_save( SUFFIXTREE *tree, const char *path );
@@ -0,0 +1,233 @@
+#include "frozen_tree.h"
+
+/* Freeze a built tree into a snapshot for concurrent queries. The
+* SUFFIXTREE is not modified and may be destroyed afterwards.
+* Parameter:  snap: the new snapshot (for return)
+*             tree: the built SUFFIXTREE
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int ctree_freeze( CTREE_SNAPSHOT **snap, SUFFIXTREE *tree )
+{
+	CTREE_SNAPSHOT *s;
+	*snap = NULL;
+	if( ( s = ( CTREE_SNAPSHOT * )malloc( sizeof( CTREE_SNAPSHOT ) ) ) == NULL )
+		return 1;
+	if( ctree_build( &s->tree, tree ) ){
+		free( s );
+		return 1;
+	}
+	s->next = NULL;
+	*snap = s;
+	return 0;
+}
+
+/* Make a snapshot of a file written by ctree_save or stree_save,
+* mapped read-only
+* Parameter:  snap: the new snapshot (for return)
+*             path: the snapshot file
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int ctree_freeze_file( CTREE_SNAPSHOT **snap, const char *path )
+{
+	CTREE_SNAPSHOT *s;
+	*snap = NULL;
+	if( ( s = ( CTREE_SNAPSHOT * )malloc( sizeof( CTREE_SNAPSHOT ) ) ) == NULL )
+		return 1;
+	if( ctree_load( &s->tree, path ) ){
+		free( s );
+		return 1;
+	}
+	s->next = NULL;
+	*snap = s;
+	return 0;
+}
+
+/* Free a snapshot no reader holds
+* Last modified: 10/18/2026
+*/
+
+void ctree_snapshot_free( CTREE_SNAPSHOT *snap )
+{
+	if( snap == NULL )
+		return;
+	ctree_free( &snap->tree );
+	free( snap );
+}
+
+/* Publish the first snapshot
+* Parameter:  rcu:  the CTREE_RCU
+*             snap: the snapshot, owned by rcu from now on
+* Last modified: 10/18/2026
+*/
+
+void ctree_rcu_init( CTREE_RCU *rcu, CTREE_SNAPSHOT *snap )
+{
+	memset( ( void * )rcu, 0, sizeof( CTREE_RCU ) );
+	pthread_mutex_init( &rcu->lock, NULL );
+	rcu->current = snap;
+}
+
+/* Free every snapshot of a CTREE_RCU. No reader may be inside.
+* Last modified: 10/18/2026
+*/
+
+void ctree_rcu_destroy( CTREE_RCU *rcu )
+{
+	CTREE_SNAPSHOT *s;
+	ctree_snapshot_free( rcu->current );
+	while( ( s = rcu->retired ) != NULL ){
+		rcu->retired = s->next;
+		ctree_snapshot_free( s );
+	}
+	pthread_mutex_destroy( &rcu->lock );
+	memset( ( void * )rcu, 0, sizeof( CTREE_RCU ) );
+}
+
+/* Take a reader slot, once for each reader thread
+* Return:     the slot, -1 if all CTREE_RCU_READERS are taken
+* Last modified: 10/18/2026
+*/
+
+int ctree_rcu_register( CTREE_RCU *rcu )
+{
+	int i;
+	for( i = 0; i < CTREE_RCU_READERS; i++ ){
+		if( __atomic_exchange_n( &rcu->reader[i].used, 1, __ATOMIC_ACQ_REL ) == 0 )
+			return i;
+	}
+	return -1;
+}
+
+/* Give a reader slot back
+* Last modified: 10/18/2026
+*/
+
+void ctree_rcu_unregister( CTREE_RCU *rcu, int reader )
+{
+	ctree_rcu_leave( rcu, reader );
+	__atomic_store_n( &rcu->reader[reader].used, 0, __ATOMIC_RELEASE );
+}
+
+/* Free the retired snapshots no slot holds. The lock is held.
+* Return:     the number of snapshots freed
+*/
+
+static int ctree_rcu_collect( CTREE_RCU *rcu )
+{
+	CTREE_SNAPSHOT **p, *s;
+	int i, n;
+
+	for( p = &rcu->retired, n = 0; ( s = *p ) != NULL; ){
+		for( i = 0; i < CTREE_RCU_READERS; i++ ){
+			if( __atomic_load_n( &rcu->reader[i].snap, __ATOMIC_SEQ_CST ) == s )
+				break;
+		}
+		if( i < CTREE_RCU_READERS ){
+			p = &s->next;
+			continue;
+		}
+		__atomic_store_n( p, s->next, __ATOMIC_RELEASE );
+		ctree_snapshot_free( s );
+		n++;
+	}
+	return n;
+}
+
+/* Let the lock go, collecting again first for each reader that
+* left while it was held and could not take it
+*/
+
+static void ctree_rcu_unlock( CTREE_RCU *rcu )
+{
+	for( ;; ){
+		pthread_mutex_unlock( &rcu->lock );
+		if( __atomic_load_n( &rcu->recheck, __ATOMIC_SEQ_CST ) == 0 ||
+			pthread_mutex_trylock( &rcu->lock ) != 0 )
+			return;
+		__atomic_store_n( &rcu->recheck, 0, __ATOMIC_SEQ_CST );
+		ctree_rcu_collect( rcu );
+	}
+}
+
+/* Start a query: hold the current snapshot. The slot is set before
+* the snapshot is checked to be still current, so a swap that
+* retires it afterwards sees the slot and keeps it.
+* Parameter:  rcu:    the CTREE_RCU
+*             reader: the slot of the calling thread
+* Return:     the tree to query until ctree_rcu_leave, NULL if none
+* Last modified: 10/18/2026
+*/
+
+const COMPACTTREE *ctree_rcu_enter( CTREE_RCU *rcu, int reader )
+{
+	CTREE_SNAPSHOT *s;
+	do{
+		s = __atomic_load_n( &rcu->current, __ATOMIC_SEQ_CST );
+		__atomic_store_n( &rcu->reader[reader].snap, s, __ATOMIC_SEQ_CST );
+	}while( __atomic_load_n( &rcu->current, __ATOMIC_SEQ_CST ) != s );
+	return s == NULL ? NULL : &s->tree;
+}
+
+/* End a query. A reader leaving a retired snapshot frees it if it
+* was the last one. The recheck is set before the lock is tried, so
+* if another thread holds it, that thread sees the recheck when it
+* lets the lock go and collects for this reader; leave never blocks.
+* Last modified: 10/18/2026
+*/
+
+void ctree_rcu_leave( CTREE_RCU *rcu, int reader )
+{
+	__atomic_store_n( &rcu->reader[reader].snap, ( CTREE_SNAPSHOT * )NULL, __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &rcu->retired, __ATOMIC_ACQUIRE ) == NULL )
+		return;
+	__atomic_store_n( &rcu->recheck, 1, __ATOMIC_SEQ_CST );
+	if( pthread_mutex_trylock( &rcu->lock ) == 0 ){
+		__atomic_store_n( &rcu->recheck, 0, __ATOMIC_SEQ_CST );
+		ctree_rcu_collect( rcu );
+		ctree_rcu_unlock( rcu );
+	}
+}
+
+/* Publish a new snapshot. Queries entering from now on get it at
+* once; the old one is retired, and freed as soon as no reader
+* holds it.
+* Parameter:  rcu:  the CTREE_RCU
+*             snap: the new snapshot, owned by rcu from now on
+* Last modified: 10/18/2026
+*/
+
+void ctree_rcu_swap( CTREE_RCU *rcu, CTREE_SNAPSHOT *snap )
+{
+	CTREE_SNAPSHOT *old;
+	old = __atomic_exchange_n( &rcu->current, snap, __ATOMIC_SEQ_CST );
+	pthread_mutex_lock( &rcu->lock );
+	if( old != NULL ){
+		old->next = rcu->retired;
+		__atomic_store_n( &rcu->retired, old, __ATOMIC_RELEASE );
+	}
+	__atomic_store_n( &rcu->recheck, 0, __ATOMIC_SEQ_CST );
+	ctree_rcu_collect( rcu );
+	ctree_rcu_unlock( rcu );
+}
+
+/* Free the retired snapshots no reader holds any more
+* Return:     the number of snapshots still retired
+* Last modified: 10/18/2026
+*/
+
+int ctree_rcu_reclaim( CTREE_RCU *rcu )
+{
+	CTREE_SNAPSHOT *s;
+	int n;
+	pthread_mutex_lock( &rcu->lock );
+	__atomic_store_n( &rcu->recheck, 0, __ATOMIC_SEQ_CST );
+	ctree_rcu_collect( rcu );
+	for( s = rcu->retired, n = 0; s != NULL; s = s->next )
+		n++;
+	ctree_rcu_unlock( rcu );
+	return n;
+}
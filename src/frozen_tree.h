@@ -0,0 +1,54 @@
+#pragma once
+
+#include "compact_tree.h"
+#include <pthread.h>
+
+/* Frozen trees for concurrent queries.
+*
+* ctree_freeze turns a built SUFFIXTREE into a CTREE_SNAPSHOT, whose
+* COMPACTTREE is never written again: every ctree_ query takes it as
+* const and keeps its state on the caller's stack, so any number of
+* threads query one snapshot without locks.
+*
+* A CTREE_RCU publishes the current snapshot. A reader thread takes
+* a slot with ctree_rcu_register, and brackets its queries with
+* ctree_rcu_enter and ctree_rcu_leave; neither call blocks. The slot
+* shows the snapshot the reader holds. ctree_rcu_swap publishes a new
+* snapshot at once and retires the old one, which is freed when no
+* slot holds it any more, by the swap itself or by the last reader
+* to leave it. A reader that finds the lock taken leaves a recheck
+* for its holder, which collects again before it lets the lock go.
+*/
+
+#define CTREE_RCU_READERS 64
+
+typedef struct ctree_snapshot{
+	COMPACTTREE tree;
+	struct ctree_snapshot *next;    /*in the retired list*/
+}CTREE_SNAPSHOT;
+
+typedef struct ctree_reader{
+	CTREE_SNAPSHOT *snap;           /*held by the reader, NULL outside a query*/
+	int used;
+	char pad[64 - sizeof( void * ) - sizeof( int )];
+}CTREE_READER;
+
+typedef struct ctree_rcu{
+	CTREE_SNAPSHOT *current;
+	CTREE_SNAPSHOT *retired;
+	pthread_mutex_t lock;           /*taken by swaps and reclaims, never by enter*/
+	int recheck;                    /*a reader left while the lock was taken*/
+	CTREE_READER reader[CTREE_RCU_READERS];
+}CTREE_RCU;
+
+int ctree_freeze( CTREE_SNAPSHOT **snap, SUFFIXTREE *tree );
+int ctree_freeze_file( CTREE_SNAPSHOT **snap, const char *path );
+void ctree_snapshot_free( CTREE_SNAPSHOT *snap );
+void ctree_rcu_init( CTREE_RCU *rcu, CTREE_SNAPSHOT *snap );
+void ctree_rcu_destroy( CTREE_RCU *rcu );
+int ctree_rcu_register( CTREE_RCU *rcu );
+void ctree_rcu_unregister( CTREE_RCU *rcu, int reader );
+const COMPACTTREE *ctree_rcu_enter( CTREE_RCU *rcu, int reader );
+void ctree_rcu_leave( CTREE_RCU *rcu, int reader );
+void ctree_rcu_swap( CTREE_RCU *rcu, CTREE_SNAPSHOT *snap );
+int ctree_rcu_reclaim( CTREE_RCU *rcu );
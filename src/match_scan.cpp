@@ -0,0 +1,292 @@
+#include "match_scan.h"
+#include <unistd.h>
+
+#define CTREE_SCAN_READ  ( 1 << 20 )
+
+/* Set up a scanner over a compact tree
+* Parameter:  s:        the CTREE_SCANNER
+*             c:        the COMPACTTREE, not modified
+*             min_mem:  the shortest MEM to report, 0 for none
+*             on_match: called with the matching statistics, may be NULL
+*             on_mem:   called with the MEMs, may be NULL
+*             arg:      passed to the callbacks
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int ctree_scan_init( CTREE_SCANNER *s, const COMPACTTREE *c, unsigned int min_mem,
+	CTREE_MATCH_FN on_match, CTREE_MEM_FN on_mem, void *arg )
+{
+	memset( ( void * )s, 0, sizeof( CTREE_SCANNER ) );
+	s->c = c;
+	s->min_mem = on_mem == NULL ? 0 : min_mem;
+	s->on_match = on_match;
+	s->on_mem = on_mem;
+	s->arg = arg;
+	s->prev = -1;
+	if( c->node_count == 0 ||
+		( s->match = ( CTREE_MATCH * )malloc( sizeof( CTREE_MATCH ) * CTREE_SCAN_BATCH ) ) == NULL ||
+		( s->mem = ( CTREE_MEM * )malloc( sizeof( CTREE_MEM ) * CTREE_SCAN_BATCH ) ) == NULL ){
+		ctree_scan_free( s );
+		return 1;
+	}
+	return 0;
+}
+
+/* Free the buffers of a scanner
+* Last modified: 10/18/2026
+*/
+
+void ctree_scan_free( CTREE_SCANNER *s )
+{
+	free( s->win );
+	free( s->match );
+	free( s->mem );
+	memset( ( void * )s, 0, sizeof( CTREE_SCANNER ) );
+}
+
+/* Pass the collected results to the callbacks
+* Return:     1 if a callback stops the scan, 0 otherwise
+*/
+
+static int ctree_scan_flush( CTREE_SCANNER *s )
+{
+	int ret = 0;
+	if( s->match_num > 0 && s->on_match != NULL )
+		ret = s->on_match( s->arg, s->match, s->match_num );
+	s->match_num = 0;
+	if( s->mem_num > 0 && ret == 0 )
+		ret = s->on_mem( s->arg, s->mem, s->mem_num );
+	s->mem_num = 0;
+	return ret;
+}
+
+/* Extend the match at qpos as far as the window allows
+* Return:     1 if it ended on a mismatch, 0 if it ran out of characters
+*/
+
+static int ctree_scan_extend( CTREE_SCANNER *s )
+{
+	const COMPACTTREE *c = s->c;
+	unsigned int u, d, pd, child;
+	unsigned char ch;
+	int ret = 0;
+
+	u = s->node;
+	d = s->depth;
+	pd = u == 0 ? 0 : c->char_depth[c->parent[u]];
+	while( s->head + d < s->win_len ){
+		ch = ( unsigned char )s->win[s->head + d];
+		if( d == c->char_depth[u] ){
+			/* at a node: take the child starting with ch */
+			if( ch == 0 || ( child = ctree_get_child( c, u, ( char )ch ) ) == CTREE_NIL ){
+				ret = 1;
+				break;
+			}
+			pd = d;
+			u = child;
+		}
+		else if( ch == 0 || ( unsigned char )c->text[c->nodes[u].edge_start + d - pd] != ch ){
+			ret = 1;
+			break;
+		}
+		d++;
+	}
+	s->node = u;
+	s->depth = d;
+	return ret;
+}
+
+/* Record the MEMs of length len at qpos among the occurrences
+* occ[from] .. occ[to-1], the ones that are left maximal. A run of
+* occurrences the match at qpos-1 extends is passed by left_next,
+* which lands on one that is reported or past to.
+* Return:     1 if a callback stops the scan, 0 otherwise
+*/
+
+static int ctree_scan_mems( CTREE_SCANNER *s, unsigned int from, unsigned int to, unsigned int len )
+{
+	const COMPACTTREE *c = s->c;
+	const OCCURRENCE *o;
+	unsigned int k;
+
+	for( k = from; k < to; k++ ){
+		if( ( int )ctree_left_char( c, k ) == s->prev ){
+			k = c->left_next[k] - 1;
+			continue;
+		}
+		o = &c->occ[k];
+		s->mem[s->mem_num].qpos = s->qpos;
+		s->mem[s->mem_num].length = len;
+		s->mem[s->mem_num].str_id = o->str_id;
+		s->mem[s->mem_num].str_start = o->str_start;
+		if( ++s->mem_num == CTREE_SCAN_BATCH && ctree_scan_flush( s ) )
+			return 1;
+	}
+	return 0;
+}
+
+/* Record the match at qpos and the MEMs it gives: every occurrence
+* of the longest match, then, at each node of its path at depth
+* min_mem or more, the occurrences that leave the path there, for
+* which the match of that depth cannot be extended to the right.
+* A run of nodes where all of those have the character before qpos
+* on their left is passed at once by side_up, so the time goes with
+* the MEMs reported rather than the length of the path.
+* Return:     1 if a callback stops the scan, 0 otherwise
+*/
+
+static int ctree_scan_emit( CTREE_SCANNER *s )
+{
+	const COMPACTTREE *c = s->c;
+	unsigned int u, w;
+
+	if( s->on_match != NULL ){
+		s->match[s->match_num].qpos = s->qpos;
+		s->match[s->match_num].length = s->depth;
+		s->match[s->match_num].node = s->node;
+		if( ++s->match_num == CTREE_SCAN_BATCH && ctree_scan_flush( s ) )
+			return 1;
+	}
+	if( s->min_mem == 0 || s->depth < s->min_mem )
+		return 0;
+	w = s->node;
+	if( ctree_scan_mems( s, c->occ_begin[w], c->occ_end[w], s->depth ) )
+		return 1;
+	for( u = c->parent[w]; u != 0 && c->char_depth[u] >= s->min_mem; u = c->parent[w] ){
+		if( ( int )c->side_char[w] == s->prev ){
+			w = c->side_up[w];
+			continue;
+		}
+		if( ctree_scan_mems( s, c->occ_begin[u], c->occ_begin[w], c->char_depth[u] ) ||
+			ctree_scan_mems( s, c->occ_end[w], c->occ_end[u], c->char_depth[u] ) )
+			return 1;
+		w = u;
+	}
+	return 0;
+}
+
+/* Move the match to the next position: drop its first character
+* by the suffix link of the locus, or of its parent followed by a
+* skip-count rescan of the characters known to match
+*/
+
+static void ctree_scan_advance( CTREE_SCANNER *s )
+{
+	const COMPACTTREE *c = s->c;
+	unsigned int u, d, x;
+
+	u = s->node;
+	d = s->depth;
+	s->prev = ( unsigned char )s->win[s->head];
+	s->head++;
+	s->qpos++;
+	if( d == 0 )
+		return;
+	s->depth = --d;
+	if( d + 1 == c->char_depth[u] && c->nodes[u].suffix_link != CTREE_NIL ){
+		s->node = c->nodes[u].suffix_link;
+		return;
+	}
+	x = c->parent[u];
+	x = x == 0 || c->nodes[x].suffix_link == CTREE_NIL ? 0 : c->nodes[x].suffix_link;
+	while( c->char_depth[x] < d )
+		x = ctree_get_child( c, x, s->win[s->head + c->char_depth[x]] );
+	s->node = x;
+}
+
+/* Scan the window
+* Parameter:  s:    the CTREE_SCANNER
+*             last: 1 if the query ends with the window
+* Return:     1 if a callback stops the scan, 0 otherwise
+*/
+
+static int ctree_scan_run( CTREE_SCANNER *s, int last )
+{
+	while( s->head < s->win_len ){
+		if( !ctree_scan_extend( s ) && !last )
+			return 0;
+		if( ctree_scan_emit( s ) )
+			return 1;
+		ctree_scan_advance( s );
+	}
+	return 0;
+}
+
+/* Scan the next piece of the query. The positions whose match may
+* still grow are kept until more of the query, or its end, comes.
+* Parameter:  s:        the CTREE_SCANNER
+*             buf, len: the query characters
+* Return:     0 if successful, 1 if out of memory or stopped
+*             by a callback
+* Last modified: 10/18/2026
+*/
+
+int ctree_scan_feed( CTREE_SCANNER *s, const char *buf, size_t len )
+{
+	size_t size;
+	char *win;
+
+	if( s->head > 0 ){
+		memmove( s->win, s->win + s->head, s->win_len - s->head );
+		s->win_len -= s->head;
+		s->head = 0;
+	}
+	if( s->win_len + len > s->win_size ){
+		for( size = s->win_size == 0 ? 4096 : s->win_size; size < s->win_len + len; size *= 2 );
+		if( ( win = ( char * )realloc( s->win, size ) ) == NULL )
+			return 1;
+		s->win = win;
+		s->win_size = size;
+	}
+	memcpy( s->win + s->win_len, buf, len );
+	s->win_len += len;
+	return ctree_scan_run( s, 0 );
+}
+
+/* End the query: report the positions left and flush the results.
+* The scanner is then ready for a new query from position 0.
+* Return:     0 if successful, 1 if stopped by a callback
+* Last modified: 10/18/2026
+*/
+
+int ctree_scan_finish( CTREE_SCANNER *s )
+{
+	int ret;
+	ret = ctree_scan_run( s, 1 );
+	if( ctree_scan_flush( s ) )
+		ret = 1;
+	s->head = s->win_len = 0;
+	s->qpos = 0;
+	s->node = s->depth = 0;
+	s->prev = -1;
+	return ret;
+}
+
+/* Scan a query read from a file descriptor to its end
+* Parameter:  s:  the CTREE_SCANNER
+*             fd: the open file descriptor
+* Return:     0 if successful, 1 on a read error, out of memory
+*             or stopped by a callback
+* Last modified: 10/18/2026
+*/
+
+int ctree_scan_fd( CTREE_SCANNER *s, int fd )
+{
+	char *buf;
+	ssize_t got;
+	int ret = 0;
+
+	if( ( buf = ( char * )malloc( CTREE_SCAN_READ ) ) == NULL )
+		return 1;
+	while( ret == 0 && ( got = read( fd, buf, CTREE_SCAN_READ ) ) != 0 ){
+		if( got < 0 )
+			ret = 1;
+		else
+			ret = ctree_scan_feed( s, buf, got );
+	}
+	free( buf );
+	if( ctree_scan_finish( s ) )
+		ret = 1;
+	return ret;
+}
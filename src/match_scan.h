@@ -0,0 +1,73 @@
+#pragma once
+
+#include "compact_tree.h"
+
+/* Matching statistics of a query stream against a compact tree.
+*
+* For every position of the query, the scanner finds the longest
+* prefix of the query from there that occurs in the tree, and its
+* locus. After each position the match moves on by the suffix link
+* of its locus and a skip-count rescan, so the whole query takes
+* linear time. The query may come in pieces of any size; a position
+* is reported once its match has ended on a mismatch or the query
+* has ended.
+*
+* With min_mem set, it also reports the maximal exact matches of
+* that length or more, those that cannot be extended to the left or
+* to the right: at each position, every occurrence of the longest
+* match, and for each node on its path at depth min_mem or more, the
+* occurrences that leave the path there, with the length of that
+* node. The ones whose previous character is that of the query are
+* left out, as they belong to the match of the position before; the
+* left characters kept in the COMPACTTREE pass them, and the nodes
+* that would report only them, without a look, so the MEMs cost time
+* in proportion to their number.
+*
+* Results are collected in batches of CTREE_SCAN_BATCH and passed to
+* the callbacks, which stop the scan by returning non-zero.
+*/
+
+#define CTREE_SCAN_BATCH  4096
+
+typedef struct ctree_match{
+	unsigned long long qpos;    /*the position in the query*/
+	unsigned int length;        /*the longest match starting there*/
+	unsigned int node;          /*its locus, 0 (the root) if length is 0*/
+}CTREE_MATCH;
+
+typedef struct ctree_mem{
+	unsigned long long qpos;
+	unsigned int length;
+	unsigned int str_id;        /*the occurrence in the tree*/
+	unsigned int str_start;
+}CTREE_MEM;
+
+typedef int ( *CTREE_MATCH_FN )( void *arg, const CTREE_MATCH *match, unsigned int num );
+typedef int ( *CTREE_MEM_FN )( void *arg, const CTREE_MEM *mem, unsigned int num );
+
+typedef struct ctree_scanner{
+	const COMPACTTREE *c;
+	unsigned int min_mem;       /*0 for no MEMs*/
+	CTREE_MATCH_FN on_match;    /*NULL for no matching statistics*/
+	CTREE_MEM_FN on_mem;
+	void *arg;
+	char *win;                  /*the query characters not yet passed*/
+	size_t head;                /*win[head] is the character at qpos*/
+	size_t win_len;
+	size_t win_size;
+	unsigned long long qpos;    /*the position whose match is extended*/
+	unsigned int node;          /*the locus of the match*/
+	unsigned int depth;         /*the length of the match*/
+	int prev;                   /*the character before qpos, -1 at the start*/
+	CTREE_MATCH *match;
+	unsigned int match_num;
+	CTREE_MEM *mem;
+	unsigned int mem_num;
+}CTREE_SCANNER;
+
+int ctree_scan_init( CTREE_SCANNER *s, const COMPACTTREE *c, unsigned int min_mem,
+	CTREE_MATCH_FN on_match, CTREE_MEM_FN on_mem, void *arg );
+void ctree_scan_free( CTREE_SCANNER *s );
+int ctree_scan_feed( CTREE_SCANNER *s, const char *buf, size_t len );
+int ctree_scan_finish( CTREE_SCANNER *s );
+int ctree_scan_fd( CTREE_SCANNER *s, int fd );
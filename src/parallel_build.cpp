@@ -0,0 +1,407 @@
+#include "suffix_tree.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+
+/* Two nodes whose subtrees are to be merged: first is in the
+* tree being built, second comes from the tree merged into it */
+typedef pair< NODE *, NODE * > MERGEPAIR;
+
+typedef struct stree_shard{
+	SUFFIXTREE tree;
+	char **strings;
+	unsigned int num;
+	SUFFIXTREE *from;       /*the shard merged into tree by a merge pass*/
+	int status;
+}STREE_SHARD;
+
+/* Move the string IDs of node from to the end of those of node to.
+* Every ID of from is larger, so the list stays sorted.
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int stree_merge_strings( STREE_ARENA *arena, NODE *to, NODE *from )
+{
+	STRINGID s;
+	unsigned int pos;
+	for( pos = 0; stree_posting_next( &from->strings, &pos, &s ); ){
+		if( stree_posting_append( arena, &to->strings, s.str_id, s.str_start ) )
+			return 1;
+	}
+	stree_posting_free( arena, &from->strings );
+	to->stringid_num += from->stringid_num;
+	return 0;
+}
+
+/* Return a node that has been merged away to the arena, together
+* with its child list and child index
+* Last modified:  10/18/2026
+*/
+
+static void stree_merge_release( STREE_ARENA *arena, NODE *node )
+{
+	CHILD_STRUCT *c, *next;
+	for( c = node->children; c != NULL; c = next ){
+		next = c->next;
+		stree_pool_free( &arena->children, c );
+	}
+	if( node->child_index != NULL )
+		stree_pool_free( &arena->index[node->child_index->kind], node->child_index );
+	node->children = NULL;
+	node->child_index = NULL;
+	stree_free_node( arena, node );
+}
+
+/* Merge node b into node a, both with the same path label
+* Parameter:  arena:      the arena of the tree of a
+*             a, b:       the nodes
+*             stack:      the pairs left to merge (for return)
+*             node_count: the total number of nodes in the tree
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int stree_merge_node( STREE_ARENA *arena, NODE *a, NODE *b,
+	vector< MERGEPAIR > &stack, unsigned int *node_count )
+{
+	CHILD_STRUCT *c;
+	NODE *n;
+
+	if( a->node_type == LEAF && b->node_type == LEAF ){
+		if( stree_merge_strings( arena, a, b ) )
+			return 1;
+		stree_merge_release( arena, b );
+		return 0;
+	}
+	if( a->node_type == LEAF ){
+		/* the suffixes of a end where b goes on, split a at its end */
+		if( ( n = stree_alloc_node( arena, INTERNODE ) ) == NULL ||
+			stree_link_node( arena, n, a, a->edgelen - 1, node_count ) )
+			return 1;
+		a = n;
+	}
+	if( b->node_type == LEAF ){
+		/* hang the suffixes of b under a on an empty edge */
+		b->start_char += b->edgelen;
+		b->edgelen = 0;
+		stack.push_back( MERGEPAIR( a, b ) );
+		return 0;
+	}
+	if( stree_merge_strings( arena, a, b ) )
+		return 1;
+	for( c = b->children; c != NULL; c = c->next )
+		stack.push_back( MERGEPAIR( a, c->child ) );
+	stree_merge_release( arena, b );
+	return 0;
+}
+
+/* Merge the subtree of b into the children of a. The edge of b
+* starts right below a.
+* Parameter:  arena:      the arena of the tree of a
+*             a:          the internal node
+*             b:          the node to be merged
+*             stack:      the pairs left to merge (for return)
+*             node_count: the total number of nodes in the tree
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int stree_merge_child( STREE_ARENA *arena, NODE *a, NODE *b,
+	vector< MERGEPAIR > &stack, unsigned int *node_count )
+{
+	CHILD_STRUCT *t;
+	NODE *x, *n;
+	unsigned int k, len;
+
+	if( EMPTY_EDGE( b ) ){
+		/* a has at most one empty edge, kept at the head of the list */
+		if( a->children != NULL && EMPTY_EDGE( a->children->child ) ){
+			if( stree_merge_strings( arena, a->children->child, b ) )
+				return 1;
+			stree_merge_release( arena, b );
+			return 0;
+		}
+		if( ( t = stree_new_child_struct( arena, b, a->children ) ) == NULL )
+			return 1;
+		a->children = t;
+		b->parent = a;
+		return 0;
+	}
+	if( ( t = stree_get_child( a, b->start_char[0] ) ) == NULL )
+		return stree_insert_child( arena, a, b, node_count ) == NULL;
+
+	x = t->child;
+	len = min( x->edgelen, b->edgelen );
+	for( k = 1; k < len && x->start_char[k] == b->start_char[k]; k++ );
+	if( k < x->edgelen ){
+		/* the labels part in the middle of the edge of x */
+		if( ( n = stree_alloc_node( arena, INTERNODE ) ) == NULL ||
+			stree_link_node( arena, n, x, k - 1, node_count ) )
+			return 1;
+		x = n;
+	}
+	if( k == b->edgelen )
+		return stree_merge_node( arena, x, b, stack, node_count );
+	if( x->node_type == LEAF ){
+		if( ( n = stree_alloc_node( arena, INTERNODE ) ) == NULL ||
+			stree_link_node( arena, n, x, x->edgelen - 1, node_count ) )
+			return 1;
+		x = n;
+	}
+	b->start_char += k;
+	b->edgelen -= k;
+	stack.push_back( MERGEPAIR( x, b ) );
+	return 0;
+}
+
+/* Set the suffix links and node numbers of a merged tree, in
+* breadth first order so that the link of a parent is known
+* before its children are linked
+* Parameter:  tree: the SUFFIXTREE
+* Last modified:  10/18/2026
+*/
+
+static void stree_merge_finish( SUFFIXTREE *tree )
+{
+	vector< NODE * > queue;
+	CHILD_STRUCT *c;
+	NODE *node;
+	size_t i;
+	int edgeindex;
+
+	if( tree->root == NULL )
+		return;
+	tree->root->suffix_link = tree->root->parent = tree->root;
+	queue.push_back( tree->root );
+	for( i = 0; i < queue.size(); i++ ){
+		node = queue[i];
+		node->node_num = i + 1;
+		if( node->node_type == INTERNODE && node != tree->root ){
+			if( node->parent == tree->root ){
+				node->suffix_link = stree_skip_count( tree->root, node->start_char + 1,
+					&edgeindex, node->edgelen - 1 );
+			}
+			else{
+				node->suffix_link = stree_skip_count( node->parent->suffix_link, node->start_char,
+					&edgeindex, node->edgelen );
+			}
+		}
+		for( c = node->children; c != NULL; c = c->next )
+			queue.push_back( c->child );
+	}
+	tree->node_count = queue.size();
+}
+
+/* Move the strings, nodes and chunks of tree b into tree a and
+* merge the two trees. The strings of b get the IDs following
+* those of a, its evicted strings dropped.
+* Parameter:  a, b:   the SUFFIXTREEs, b is left empty
+*             relink: 0 to leave the suffix links and node numbers
+*                     of a for a later stree_merge_finish
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int stree_merge_trees( SUFFIXTREE *a, SUFFIXTREE *b, int relink )
+{
+	vector< MERGEPAIR > stack;
+	vector< NODE * > nodes;
+	CHILD_STRUCT *c;
+	NODE *node, *root;
+	char *base;
+	unsigned int *offset, i, size;
+	int k, ret;
+
+	if( b->strnum == 0 )
+		return 0;
+	/* the evicted strings of b are not moved */
+	if( b->str_evicted > 0 && stree_window_compact( b ) )
+		return 1;
+	if( a->strnum == 0 ){
+		stree_destroy( a );
+		*a = *b;
+		stree_init( b );
+		return 0;
+	}
+	if( ( base = stree_reserve_text( a, b->text_len ) ) == NULL )
+		return 1;
+	if( a->strnum + b->strnum + 1 > a->offset_size ){
+		for( size = a->offset_size; size < a->strnum + b->strnum + 1; size *= 2 );
+		if( ( offset = ( unsigned int * )realloc( a->str_offset, sizeof( unsigned int ) * size ) ) == NULL )
+			return 1;
+		a->str_offset = offset;
+		a->offset_size = size;
+	}
+	memcpy( base, b->text, b->text_len );
+
+	/* move the edge labels of b into the text of a and renumber its strings */
+	nodes.push_back( b->root );
+	while( !nodes.empty() ){
+		node = nodes.back();
+		nodes.pop_back();
+		if( node->start_char != NULL )
+			node->start_char = base + ( node->start_char - b->text );
+		if( stree_posting_shift( &b->arena, &node->strings, a->strnum ) )
+			return 1;
+		for( c = node->children; c != NULL; c = c->next )
+			nodes.push_back( c->child );
+	}
+	for( i = 1; i <= b->strnum; i++ )
+		a->str_offset[a->strnum + i] = a->text_len + b->str_offset[i];
+	a->text_len += b->text_len;
+	a->strnum += b->strnum;
+
+	stree_pool_adopt( &a->arena.nodes, &b->arena.nodes );
+	stree_pool_adopt( &a->arena.children, &b->arena.children );
+	for( k = 0; k < POSTING_CLASSES; k++ )
+		stree_pool_adopt( &a->arena.posting[k], &b->arena.posting[k] );
+	stree_pool_adopt( &a->arena.index[CHILD_SMALL], &b->arena.index[CHILD_SMALL] );
+	stree_pool_adopt( &a->arena.index[CHILD_SORTED], &b->arena.index[CHILD_SORTED] );
+	stree_pool_adopt( &a->arena.index[CHILD_DIRECT], &b->arena.index[CHILD_DIRECT] );
+	root = b->root;
+	stree_destroy( b );
+
+	ret = stree_merge_node( &a->arena, a->root, root, stack, &a->node_count );
+	while( ret == 0 && !stack.empty() ){
+		MERGEPAIR m = stack.back();
+		stack.pop_back();
+		ret = stree_merge_child( &a->arena, m.first, m.second, stack, &a->node_count );
+	}
+	if( relink )
+		stree_merge_finish( a );
+	return ret;
+}
+
+/* Merge the tree b into the tree a. The strings of b are added to
+* a with the IDs following those of a, and the suffix links, node
+* numbers, character depths and string IDs of the leaves are kept
+* valid. Like after a stree_insert_string, the string IDs of the
+* internal nodes are left for fix_stringid.
+* Parameter:  a, b: the SUFFIXTREEs, b is left empty
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_merge( SUFFIXTREE *a, SUFFIXTREE *b )
+{
+	return stree_merge_trees( a, b, 1 );
+}
+
+static void *stree_build_shard( void *arg )
+{
+	STREE_SHARD *shard = ( STREE_SHARD * )arg;
+	unsigned int i;
+	for( i = 0; i < shard->num && shard->status == 0; i++ )
+		shard->status = stree_insert_string( &shard->tree, shard->strings[i] );
+	return NULL;
+}
+
+static void *stree_merge_shard( void *arg )
+{
+	STREE_SHARD *shard = ( STREE_SHARD * )arg;
+	shard->status = stree_merge_trees( &shard->tree, shard->from, 0 );
+	return NULL;
+}
+
+/* Run fn on each of the shards, one thread for each
+* Last modified:  10/18/2026
+*/
+
+static void stree_run_shards( STREE_SHARD **shards, int num, void *( *fn )( void * ) )
+{
+	pthread_t *threads;
+	int i, *started;
+
+	threads = ( pthread_t * )malloc( sizeof( pthread_t ) * num );
+	started = ( int * )calloc( num, sizeof( int ) );
+	for( i = 1; i < num; i++ ){
+		if( threads != NULL && started != NULL )
+			started[i] = pthread_create( &threads[i], NULL, fn, shards[i] ) == 0;
+	}
+	fn( shards[0] );
+	for( i = 1; i < num; i++ ){
+		if( started != NULL && started[i] )
+			pthread_join( threads[i], NULL );
+		else
+			fn( shards[i] );
+	}
+	free( threads );
+	free( started );
+}
+
+/* Insert strings into the tree using several threads. The strings
+* are cut into groups of about the same number of characters, a
+* shard tree is built for each group in its own thread, and the
+* shards are merged pairwise, also in parallel, before the result
+* is merged into the tree. The strings get the same IDs as if they
+* were inserted one by one.
+* Parameter:  tree:    the SUFFIXTREE
+*             strings: the strings to be inserted
+*             num:     the number of strings
+*             threads: the number of threads, 0 for one per CPU
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_build_parallel( SUFFIXTREE *tree, char **strings, unsigned int num, int threads )
+{
+	STREE_SHARD *shard, **run;
+	unsigned long long total, done;
+	unsigned int i, first;
+	int n, k, step, ret;
+
+	if( num == 0 )
+		return 0;
+	if( threads <= 0 )
+		threads = ( int )sysconf( _SC_NPROCESSORS_ONLN );
+	if( threads < 1 )
+		threads = 1;
+	if( ( unsigned int )threads > num )
+		threads = num;
+	shard = ( STREE_SHARD * )calloc( threads, sizeof( STREE_SHARD ) );
+	run = ( STREE_SHARD ** )malloc( sizeof( STREE_SHARD * ) * threads );
+	if( shard == NULL || run == NULL ){
+		free( shard );
+		free( run );
+		return 1;
+	}
+
+	/* contiguous groups keep the string IDs in input order */
+	for( i = 0, total = 0; i < num; i++ )
+		total += strlen( strings[i] ) + 1;
+	for( n = 0, i = 0, first = 0, done = 0; n < threads; n++ ){
+		while( i < num - ( threads - n - 1 ) && ( i == first || done * threads < total * ( n + 1 ) ) )
+			done += strlen( strings[i++] ) + 1;
+		if( n == threads - 1 )
+			i = num;
+		stree_init( &shard[n].tree );
+		shard[n].strings = strings + first;
+		shard[n].num = i - first;
+		run[n] = &shard[n];
+		first = i;
+	}
+	stree_run_shards( run, threads, stree_build_shard );
+
+	ret = 0;
+	for( n = 0; n < threads; n++ )
+		ret |= shard[n].status;
+	for( step = 1; ret == 0 && step < threads; step *= 2 ){
+		for( n = 0, k = 0; n + step < threads; n += 2 * step, k++ ){
+			shard[n].from = &shard[n+step].tree;
+			run[k] = &shard[n];
+		}
+		stree_run_shards( run, k, stree_merge_shard );
+		for( n = 0; n + step < threads; n += 2 * step )
+			ret |= shard[n].status;
+	}
+	if( ret == 0 ){
+		ret = stree_merge_trees( tree, &shard[0].tree, 0 );
+		stree_merge_finish( tree );
+	}
+	for( n = 0; n < threads; n++ )
+		stree_destroy( &shard[n].tree );
+	free( shard );
+	free( run );
+	return ret;
+}
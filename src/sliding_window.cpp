@@ -0,0 +1,290 @@
+#include "suffix_tree.h"
+#include "stree_walk.h"
+#include <vector>
+
+/* Sliding window over the strings of a tree.
+*
+* The oldest string is evicted suffix by suffix. The node holding
+* the STRINGID of each suffix is found from that of the previous
+* suffix by the suffix link of its parent, so all of them are found
+* in O(length) as in the construction. The STRINGID comes off the
+* front of its posting list, since the string has the smallest ID
+* left; a leaf left with none is freed, and a parent left with one
+* child is merged into it, so the tree stays the suffix tree of the
+* suffixes that remain and every suffix link keeps its node.
+*
+* Edge labels may still point into the text of evicted strings,
+* which stays in place until it is STREE_WINDOW_SLACK times the live
+* text. It is then dropped in one walk that points each label at an occurrence
+* in a live string, renumbers the strings and the nodes and moves
+* the live text to the front.
+*/
+
+#define STREE_NO_OCC  0xFFFFFFFFu
+
+/* The evicted text is dropped when it is this many times the live
+* text, which is small next to the nodes */
+#define STREE_WINDOW_SLACK  4
+
+/* Remove the STRINGID of string str_id from node, the leaf or empty
+* edge holding it, and the nodes that are left without a purpose
+* Return:     0 if successful, 1 otherwise
+*/
+
+static int stree_window_drop( SUFFIXTREE *tree, NODE *node, unsigned int str_id )
+{
+	STREE_ARENA *arena = &tree->arena;
+	CHILD_STRUCT *t;
+	NODE *parent, *child;
+	STRINGID s;
+	unsigned int pos;
+
+	pos = 0;
+	if( !stree_posting_next( &node->strings, &pos, &s ) || s.str_id != str_id )
+		return 1;
+	if( stree_posting_pop( arena, &node->strings ) )
+		return 1;
+	if( node->stringid_num > 0 )
+		node->stringid_num--;
+	if( node->strings.count != 0 )
+		return 0;
+	parent = node->parent;
+	stree_remove_child( arena, parent, node );
+	stree_free_node( arena, node );
+	if( parent == tree->root || parent->children->next != NULL )
+		return 0;
+
+	child = parent->children->child;
+	stree_remove_child( arena, parent, child );
+	if( EMPTY_EDGE( child ) ){
+		/* the suffixes ending at parent go no further, it becomes their
+		leaf, with a label that ends at the end of one of them */
+		stree_posting_free( arena, &parent->strings );
+		parent->strings = child->strings;
+		parent->stringid_num = child->stringid_num;
+		parent->node_type = LEAF;
+		memset( ( void * )&child->strings, 0, sizeof( POSTING ) );
+		stree_free_node( arena, child );
+		pos = 0;
+		stree_posting_next( &parent->strings, &pos, &s );
+		parent->start_char = tree->text + tree->str_offset[s.str_id - 1] + s.str_start
+			+ parent->char_depth - parent->edgelen;
+		return 0;
+	}
+	/* the label of child follows that of parent in the text */
+	t = stree_get_child( parent->parent, parent->start_char[0] );
+	assert( t != NULL && t->child == parent );
+	t->child = child;
+	child->start_char -= parent->edgelen;
+	child->edgelen += parent->edgelen;
+	child->parent = parent->parent;
+	stree_free_node( arena, parent );
+	return 0;
+}
+
+/* Evict the oldest string of the tree: its suffixes and STRINGIDs
+* are removed and their nodes given back to the arena, in amortized
+* O(length of the string). Not while a string is open in an
+* STREE_BUILDER. The derived counts of the internal nodes, as set by
+* stree_count_strings or fix_stringid, are left to be counted again.
+* Parameter: tree: the SUFFIXTREE
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_evict_string( SUFFIXTREE *tree )
+{
+	NODE *node, *next, *holder, *parent;
+	unsigned int s, len, j;
+	int edgeindex;
+	char *last;
+
+	s = tree->str_evicted + 1;
+	if( s > tree->strnum || tree->str_offset[tree->strnum] != tree->text_len )
+		return 1;
+	last = tree->text + tree->str_offset[s - 1];
+	len = tree->str_offset[s] - tree->str_offset[s - 1] - 1;
+	node = NULL;
+	if( len > 0 ){
+		node = stree_skip_count( tree->root, last, &edgeindex, len );
+		assert( edgeindex == ( int )node->edgelen - 1 );
+	}
+	for( j = 0; j < len; j++, node = next ){
+		/* suffix j ends at the end of the edge of node */
+		holder = node->node_type == LEAF ? node : node->children->child;
+		assert( holder->node_type == LEAF || EMPTY_EDGE( holder ) );
+
+		/* find where suffix j + 1 ends before any node is removed */
+		next = NULL;
+		if( j + 1 < len ){
+			parent = holder->parent;
+			if( parent->suffix_link == NULL )
+				next = stree_skip_count( tree->root, last + j + 1, &edgeindex, len - j - 1 );
+			else if( EMPTY_EDGE( holder ) )
+				next = parent->suffix_link;
+			else if( parent == tree->root )
+				next = stree_skip_count( parent, holder->start_char + 1, &edgeindex, holder->edgelen - 1 );
+			else
+				next = stree_skip_count( parent->suffix_link, holder->start_char, &edgeindex, holder->edgelen );
+		}
+		if( stree_window_drop( tree, holder, s ) )
+			return 1;
+	}
+	tree->str_evicted = s;
+	if( ( unsigned long long )( STREE_WINDOW_SLACK + 1 ) * tree->str_offset[s] > ( unsigned long long )STREE_WINDOW_SLACK * tree->text_len )
+		return stree_window_compact( tree );
+	return 0;
+}
+
+/* Evict the oldest strings until at most max_strings strings and
+* max_bytes characters are left, 0 for no limit
+* Parameter: tree:        the SUFFIXTREE
+*            max_strings: the strings to keep
+*            max_bytes:   the characters to keep
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_window_trim( SUFFIXTREE *tree, unsigned int max_strings, unsigned long long max_bytes )
+{
+	unsigned int live;
+	unsigned long long bytes;
+
+	while( tree->str_evicted < tree->strnum ){
+		live = tree->strnum - tree->str_evicted;
+		bytes = tree->str_offset[tree->strnum] - tree->str_offset[tree->str_evicted] - live;
+		if( ( max_strings == 0 || live <= max_strings ) && ( max_bytes == 0 || bytes <= max_bytes ) )
+			break;
+		if( stree_evict_string( tree ) )
+			return 1;
+	}
+	return 0;
+}
+
+/* Insert a string, then evict the oldest strings as in
+* stree_window_trim
+* Parameter: tree:        the SUFFIXTREE
+*            string:      the new string, which must not contain a 0
+*            len:         the length of the string
+*            max_strings: the strings to keep
+*            max_bytes:   the characters to keep
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_window_insert( SUFFIXTREE *tree, char *string, unsigned int len,
+	unsigned int max_strings, unsigned long long max_bytes )
+{
+	if( stree_insert_string_len( tree, string, len ) )
+		return 1;
+	return stree_window_trim( tree, max_strings, max_bytes );
+}
+
+/* Drop the STRINGIDs of the evicted strings from a posting list,
+* as left in internal nodes by fix_stringid, and renumber the rest
+* Return:     0 if successful, 1 otherwise
+*/
+
+static int stree_window_renumber( STREE_ARENA *arena, POSTING *list, unsigned int evicted )
+{
+	POSTING renumbered;
+	STRINGID s;
+	unsigned int pos;
+
+	pos = 0;
+	if( !stree_posting_next( list, &pos, &s ) )
+		return 0;
+	if( s.str_id > evicted ){
+		stree_posting_lower( list, evicted );
+		return 0;
+	}
+	memset( ( void * )&renumbered, 0, sizeof( POSTING ) );
+	for( pos = 0; stree_posting_next( list, &pos, &s ); ){
+		if( s.str_id > evicted && stree_posting_append( arena, &renumbered, s.str_id - evicted, s.str_start ) ){
+			stree_posting_free( arena, &renumbered );
+			return 1;
+		}
+	}
+	stree_posting_free( arena, list );
+	*list = renumbered;
+	return 0;
+}
+
+/* Walk of stree_window_compact: each node gets the position of an
+* occurrence of its path, from a leaf or a child, its label at that
+* occurrence and a new number */
+struct stree_window_relabel{
+	SUFFIXTREE *tree;
+	unsigned int dead;          /*the text of the evicted strings*/
+	unsigned int num;
+	vector< unsigned int > occ; /*of each open node, STREE_NO_OCC until set*/
+	int fail;
+
+	int enter( NODE *node )
+	{
+		node->node_num = ++num;
+		occ.push_back( STREE_NO_OCC );
+		return STREE_WALK_NEXT;
+	}
+	void leave( NODE *node )
+	{
+		unsigned int o, pos;
+		STRINGID s;
+
+		o = occ.back();
+		occ.pop_back();
+		if( o == STREE_NO_OCC ){
+			pos = 0;
+			if( !stree_posting_next( &node->strings, &pos, &s ) ){
+				/* only the root of an empty tree */
+				return;
+			}
+			o = tree->str_offset[s.str_id - 1] + s.str_start;
+		}
+		if( node->start_char != NULL )
+			node->start_char = tree->text + ( o + node->char_depth - node->edgelen - dead );
+		if( stree_window_renumber( &tree->arena, &node->strings, tree->str_evicted ) )
+			fail = 1;
+		if( !occ.empty() && occ.back() == STREE_NO_OCC )
+			occ.back() = o;
+	}
+};
+
+/* Drop the text of the evicted strings. The edge labels that point
+* into it are moved to the live strings, which are renumbered from 1
+* (str_base grows by the strings dropped), and the nodes numbered
+* again from 1 to node_count. Called by stree_evict_string when the
+* evicted text is STREE_WINDOW_SLACK times the live text.
+* Parameter: tree: the SUFFIXTREE
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_window_compact( SUFFIXTREE *tree )
+{
+	stree_window_relabel relabel;
+	unsigned int evicted, i;
+
+	if( ( evicted = tree->str_evicted ) == 0 )
+		return 0;
+	relabel.tree = tree;
+	relabel.dead = tree->str_offset[evicted];
+	relabel.num = 0;
+	relabel.fail = 0;
+	stree_walk( tree->root, relabel );
+	if( relabel.fail )
+		return 1;
+	memmove( tree->text, tree->text + relabel.dead, tree->text_len - relabel.dead );
+	tree->text_len -= relabel.dead;
+	for( i = 0; i + evicted <= tree->strnum; i++ )
+		tree->str_offset[i] = tree->str_offset[i + evicted] - relabel.dead;
+	tree->strnum -= evicted;
+	tree->str_base += evicted;
+	tree->str_evicted = 0;
+	tree->node_count = relabel.num;
+	return 0;
+}
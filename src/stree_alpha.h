@@ -0,0 +1,492 @@
+#pragma once
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+/* Generalized suffix trees over other symbol types.
+*
+* SUFFIXTREE works on char strings ended by 0. stree_alpha_tree is
+* the same Ukkonen construction with the symbol type and the text
+* storage given by an alphabet class:
+*
+*   stree_alpha_dna    2-bit bases, 32 to a 64-bit word
+*   stree_alpha_byte   any byte, 0 included
+*   stree_alpha_token  32-bit tokens, e.g. word IDs
+*
+* Each string is ended by a sentinel of its own, a code past the
+* alphabet that no text symbol takes, so the strings themselves may
+* hold any symbol. Nodes are kept in arrays, as in COMPACTTREE, and
+* the children of all nodes in one hash table keyed by (node, first
+* symbol), which suits small and very large alphabets alike.
+* stree_alpha_finish numbers the leaves depth first, so the
+* occurrences under a node, (string ID, start) pairs, lie in one
+* range.
+*
+* An alphabet class provides:
+*   symbol               the symbol type of the strings
+*   code                 an integer wide enough for the symbols and
+*                        the sentinels
+*   SENTINEL             the code of the sentinel of the first string
+*   valid( symbol )      whether a string may hold the symbol
+*   text                 the text storage, with push( symbol ),
+*                        get( pos ), match( pos, pattern, from, n )
+*                        and bytes()
+*   pattern              a pattern prepared for match
+*/
+
+#define STREE_ALPHA_NIL  0xFFFFFFFFu
+
+/* 2-bit DNA: symbols 0-3 (stree_alpha_dna_code maps ACGT), packed
+* 32 to a word; match compares 32 bases at a time. Other symbols
+* would collide with these once packed, so they are refused. */
+struct stree_alpha_dna{
+	typedef unsigned char symbol;
+	typedef unsigned int code;
+	static const code SENTINEL = 4;
+
+	static bool valid( symbol c ){ return c < 4; }
+
+	/* the 64 bits of the 32 symbols from pos */
+	static unsigned long long window( const unsigned long long *w, size_t pos )
+	{
+		size_t i = pos >> 5;
+		unsigned int sh = ( pos & 31 ) * 2;
+		return sh == 0 ? w[i] : ( w[i] >> sh ) | ( w[i+1] << ( 64 - sh ) );
+	}
+
+	struct pattern{
+		vector< unsigned long long > w;
+		pattern( const symbol *p, unsigned int n ) : w( ( n + 31 ) / 32 + 1, 0 )
+		{
+			for( unsigned int i = 0; i < n; i++ ){
+				assert( valid( p[i] ) );
+				w[i >> 5] |= ( unsigned long long )p[i] << ( ( i & 31 ) * 2 );
+			}
+		}
+		code get( unsigned int i ) const { return ( w[i >> 5] >> ( ( i & 31 ) * 2 ) ) & 3; }
+	};
+
+	struct text{
+		vector< unsigned long long > w;     /*one spare word for window*/
+		size_t len;
+		text() : w( 1, 0 ), len( 0 ){}
+		void push( symbol c )
+		{
+			if( ( len >> 5 ) + 1 >= w.size() )
+				w.push_back( 0 );
+			assert( valid( c ) );
+			w[len >> 5] |= ( unsigned long long )c << ( ( len & 31 ) * 2 );
+			len++;
+		}
+		code get( size_t pos ) const { return ( w[pos >> 5] >> ( ( pos & 31 ) * 2 ) ) & 3; }
+		/* the symbols matching from pos and p[from], n at most */
+		unsigned int match( size_t pos, const pattern &p, unsigned int from, unsigned int n ) const
+		{
+			unsigned long long x;
+			unsigned int k;
+			for( k = 0; k < n; k += 32 ){
+				x = window( &w[0], pos + k ) ^ window( &p.w[0], from + k );
+				if( n - k < 32 )
+					x &= ( 1ull << ( ( n - k ) * 2 ) ) - 1;
+				if( x != 0 )
+					return k + __builtin_ctzll( x ) / 2;
+			}
+			return n;
+		}
+		size_t bytes() const { return w.capacity() * sizeof( unsigned long long ); }
+	};
+};
+
+/* The 2-bit code of a base, STREE_ALPHA_DNA_BAD for anything but
+* ACGT, which stree_alpha_insert refuses */
+#define STREE_ALPHA_DNA_BAD  4
+
+inline unsigned char stree_alpha_dna_code( char c )
+{
+	switch( c ){
+	case 'A': case 'a': return 0;
+	case 'C': case 'c': return 1;
+	case 'G': case 'g': return 2;
+	case 'T': case 't': return 3;
+	default: return STREE_ALPHA_DNA_BAD;
+	}
+}
+
+/* Plain arrays of symbols, compared one at a time */
+template< class S, class C, C FIRST_SENTINEL >
+struct stree_alpha_array{
+	typedef S symbol;
+	typedef C code;
+	static const code SENTINEL = FIRST_SENTINEL;
+
+	static bool valid( symbol ){ return true; }
+
+	struct pattern{
+		const symbol *p;
+		pattern( const symbol *s, unsigned int ) : p( s ){}
+		code get( unsigned int i ) const { return p[i]; }
+	};
+
+	struct text{
+		vector< symbol > s;
+		void push( symbol c ){ s.push_back( c ); }
+		code get( size_t pos ) const { return s[pos]; }
+		unsigned int match( size_t pos, const pattern &p, unsigned int from, unsigned int n ) const
+		{
+			const symbol *a = &s[pos], *b = p.p + from;
+			unsigned int k;
+			for( k = 0; k < n && a[k] == b[k]; k++ );
+			return k;
+		}
+		size_t bytes() const { return s.capacity() * sizeof( symbol ); }
+	};
+};
+
+typedef stree_alpha_array< unsigned char, unsigned int, 256u > stree_alpha_byte;
+typedef stree_alpha_array< unsigned int, unsigned long long, 0x100000000ull > stree_alpha_token;
+
+template< class A >
+struct stree_alpha_child{
+	unsigned int node;          /*STREE_ALPHA_NIL if free*/
+	unsigned int child;
+	typename A::code c;
+};
+
+/* An occurrence: the string, numbered from 1, and the start */
+struct stree_alpha_occ{
+	unsigned int str_id;
+	unsigned int str_start;
+};
+
+template< class A >
+struct stree_alpha_tree{
+	typename A::text text;              /*the strings, a slot for each sentinel*/
+	vector< unsigned int > sent;        /*the sentinel slots, in order*/
+	vector< unsigned long long > is_sent;   /*a bit for each text slot*/
+	vector< unsigned int > start;       /*the edge of node i is text[start[i], end[i])*/
+	vector< unsigned int > end;
+	vector< unsigned int > link;        /*the suffix links, 0 (the root) by default*/
+	vector< unsigned int > leaves;      /*set by stree_alpha_finish*/
+	vector< unsigned int > occ_begin;   /*the occurrences of node i are*/
+	vector< stree_alpha_occ > occ;      /*occ[occ_begin[i] .. +leaves[i])*/
+	vector< stree_alpha_child< A > > child;
+	unsigned int child_num;
+	unsigned int strnum;
+};
+
+/* The code at a text slot */
+template< class A >
+inline typename A::code stree_alpha_at( const stree_alpha_tree< A > *t, size_t pos )
+{
+	if( ( t->is_sent[pos >> 6] >> ( pos & 63 ) ) & 1 )
+		return A::SENTINEL + ( lower_bound( t->sent.begin(), t->sent.end(), ( unsigned int )pos ) - t->sent.begin() );
+	return t->text.get( pos );
+}
+
+template< class A >
+inline size_t stree_alpha_slot( const stree_alpha_tree< A > *t, unsigned int node, typename A::code c )
+{
+	unsigned long long h = ( node + 1 ) * 0x9E3779B97F4A7C15ull ^ ( unsigned long long )c * 0xC2B2AE3D27D4EB4Full;
+	return ( h ^ ( h >> 29 ) ) & ( t->child.size() - 1 );
+}
+
+/* The child of node by the first code c, STREE_ALPHA_NIL if none */
+template< class A >
+inline unsigned int stree_alpha_child_of( const stree_alpha_tree< A > *t, unsigned int node, typename A::code c )
+{
+	size_t i;
+	for( i = stree_alpha_slot( t, node, c ); t->child[i].node != STREE_ALPHA_NIL; i = ( i + 1 ) & ( t->child.size() - 1 ) ){
+		if( t->child[i].node == node && t->child[i].c == c )
+			return t->child[i].child;
+	}
+	return STREE_ALPHA_NIL;
+}
+
+/* Set the child of node by c, adding or replacing it */
+template< class A >
+void stree_alpha_set_child( stree_alpha_tree< A > *t, unsigned int node, typename A::code c, unsigned int child )
+{
+	vector< stree_alpha_child< A > > old;
+	size_t i, k;
+
+	if( 4 * ( t->child_num + 1 ) > 3 * t->child.size() ){
+		old.swap( t->child );
+		t->child.resize( old.size() * 2 );
+		for( k = 0; k < t->child.size(); k++ )
+			t->child[k].node = STREE_ALPHA_NIL;
+		for( k = 0; k < old.size(); k++ ){
+			if( old[k].node == STREE_ALPHA_NIL )
+				continue;
+			for( i = stree_alpha_slot( t, old[k].node, old[k].c ); t->child[i].node != STREE_ALPHA_NIL;
+				i = ( i + 1 ) & ( t->child.size() - 1 ) );
+			t->child[i] = old[k];
+		}
+	}
+	for( i = stree_alpha_slot( t, node, c ); t->child[i].node != STREE_ALPHA_NIL; i = ( i + 1 ) & ( t->child.size() - 1 ) ){
+		if( t->child[i].node == node && t->child[i].c == c ){
+			t->child[i].child = child;
+			return;
+		}
+	}
+	t->child[i].node = node;
+	t->child[i].c = c;
+	t->child[i].child = child;
+	t->child_num++;
+}
+
+template< class A >
+inline unsigned int stree_alpha_new_node( stree_alpha_tree< A > *t, unsigned int start, unsigned int end )
+{
+	t->start.push_back( start );
+	t->end.push_back( end );
+	t->link.push_back( 0 );
+	return t->start.size() - 1;
+}
+
+/* Prepare an empty tree: the root alone
+* Last modified: 10/18/2026
+*/
+template< class A >
+void stree_alpha_init( stree_alpha_tree< A > *t )
+{
+	t->child.resize( 1024 );
+	for( size_t k = 0; k < t->child.size(); k++ )
+		t->child[k].node = STREE_ALPHA_NIL;
+	t->child_num = 0;
+	t->strnum = 0;
+	stree_alpha_new_node( t, 0, 0 );
+}
+
+/* Insert a string: its suffixes are added by Ukkonen's algorithm,
+* ended by a sentinel of its own, so every suffix ends at a leaf
+* Parameter:  t:        the tree
+*             s, len:   the string, of symbols the alphabet takes
+* Return:     0 if successful, 1 if a symbol is not valid or the
+*             text would pass 2^32 slots
+* Last modified: 10/18/2026
+*/
+template< class A >
+int stree_alpha_insert( stree_alpha_tree< A > *t, const typename A::symbol *s, unsigned int len )
+{
+	typename A::code c;
+	unsigned int base, last, i, ch, split, elen, edge, active, alen, remainder;
+	size_t n;
+
+	n = t->sent.empty() ? 0 : t->sent.back() + 1;
+	if( n + len + 1 >= STREE_ALPHA_NIL )
+		return 1;
+	for( i = 0; i < len; i++ ){
+		if( !A::valid( s[i] ) )
+			return 1;
+	}
+	base = n;
+	for( i = 0; i < len; i++ )
+		t->text.push( s[i] );
+	t->text.push( 0 );
+	t->sent.push_back( base + len );
+	t->is_sent.resize( ( base + len ) / 64 + 1, 0 );
+	t->is_sent[( base + len ) >> 6] |= 1ull << ( ( base + len ) & 63 );
+	t->strnum++;
+
+	active = 0;
+	edge = base;
+	alen = 0;
+	remainder = 0;
+	for( i = base; i <= base + len; i++ ){
+		c = stree_alpha_at( t, i );
+		remainder++;
+		last = STREE_ALPHA_NIL;
+		while( remainder > 0 ){
+			if( alen == 0 )
+				edge = i;
+			ch = stree_alpha_child_of( t, active, stree_alpha_at( t, edge ) );
+			if( ch == STREE_ALPHA_NIL ){
+				stree_alpha_set_child( t, active, c, stree_alpha_new_node( t, i, base + len + 1 ) );
+				if( last != STREE_ALPHA_NIL ){
+					t->link[last] = active;
+					last = STREE_ALPHA_NIL;
+				}
+			}
+			else{
+				elen = t->end[ch] - t->start[ch];
+				if( alen >= elen ){
+					/* walk down */
+					edge += elen;
+					alen -= elen;
+					active = ch;
+					continue;
+				}
+				if( stree_alpha_at( t, t->start[ch] + alen ) == c ){
+					if( last != STREE_ALPHA_NIL && active != 0 ){
+						t->link[last] = active;
+						last = STREE_ALPHA_NIL;
+					}
+					alen++;
+					break;
+				}
+				split = stree_alpha_new_node( t, t->start[ch], t->start[ch] + alen );
+				stree_alpha_set_child( t, active, stree_alpha_at( t, edge ), split );
+				stree_alpha_set_child( t, split, c, stree_alpha_new_node( t, i, base + len + 1 ) );
+				t->start[ch] += alen;
+				stree_alpha_set_child( t, split, stree_alpha_at( t, t->start[ch] ), ch );
+				if( last != STREE_ALPHA_NIL )
+					t->link[last] = split;
+				last = split;
+			}
+			remainder--;
+			if( active == 0 && alen > 0 ){
+				alen--;
+				edge = i - remainder + 1;
+			}
+			else if( active != 0 )
+				active = t->link[active];
+		}
+	}
+	return 0;
+}
+
+/* Count the leaves under every node, for stree_alpha_count, and
+* record the occurrence of each leaf, for stree_alpha_occurrences.
+* The children are gathered from the hash table by parent and the
+* nodes taken in reverse breadth-first order for the counts; then,
+* top down, each child gets the next part of the range of its
+* parent, and each leaf the string and start of its suffix, found
+* from its depth and the sentinel that ends its edge.
+* Last modified: 10/18/2026
+*/
+template< class A >
+void stree_alpha_finish( stree_alpha_tree< A > *t )
+{
+	vector< unsigned int > first( t->start.size() + 1, 0 ), kids( t->child_num ), order, parent( t->start.size(), 0 );
+	vector< unsigned int > depth( t->start.size(), 0 );
+	size_t k;
+	unsigned int i, u, next, id, pos;
+
+	for( k = 0; k < t->child.size(); k++ ){
+		if( t->child[k].node != STREE_ALPHA_NIL )
+			first[t->child[k].node + 1]++;
+	}
+	for( i = 0; i < t->start.size(); i++ )
+		first[i+1] += first[i];
+	vector< unsigned int > fill( first.begin(), first.end() - 1 );
+	for( k = 0; k < t->child.size(); k++ ){
+		if( t->child[k].node != STREE_ALPHA_NIL ){
+			kids[fill[t->child[k].node]++] = t->child[k].child;
+			parent[t->child[k].child] = t->child[k].node;
+		}
+	}
+	order.push_back( 0 );
+	for( k = 0; k < order.size(); k++ ){
+		for( i = first[order[k]]; i < first[order[k] + 1]; i++ )
+			order.push_back( kids[i] );
+	}
+	t->leaves.assign( t->start.size(), 0 );
+	for( k = order.size(); k-- > 1; ){
+		u = order[k];
+		if( first[u] == first[u + 1] )
+			t->leaves[u] = 1;
+		t->leaves[parent[u]] += t->leaves[u];
+	}
+	t->occ_begin.assign( t->start.size(), 0 );
+	t->occ.resize( t->leaves[0] );
+	for( k = 0; k < order.size(); k++ ){
+		u = order[k];
+		if( u != 0 && first[u] == first[u + 1] ){
+			/* a leaf: its edge ends just past the sentinel of its string */
+			pos = t->end[u] - depth[u];
+			id = lower_bound( t->sent.begin(), t->sent.end(), t->end[u] - 1 ) - t->sent.begin();
+			t->occ[t->occ_begin[u]].str_id = id + 1;
+			t->occ[t->occ_begin[u]].str_start = pos - ( id == 0 ? 0 : t->sent[id-1] + 1 );
+			continue;
+		}
+		for( i = first[u], next = t->occ_begin[u]; i < first[u + 1]; i++ ){
+			t->occ_begin[kids[i]] = next;
+			next += t->leaves[kids[i]];
+			depth[kids[i]] = depth[u] + t->end[kids[i]] - t->start[kids[i]];
+		}
+	}
+}
+
+/* Find the locus of a pattern: the node at or below its end
+* Parameter:  t:      the tree
+*             p, len: the pattern
+* Return:     the node, STREE_ALPHA_NIL if the pattern does not occur
+*             or has a symbol no string may hold
+* Last modified: 10/18/2026
+*/
+template< class A >
+unsigned int stree_alpha_find( const stree_alpha_tree< A > *t, const typename A::symbol *p, unsigned int len )
+{
+	unsigned int node, ch, q, m, avail, leaf;
+
+	for( q = 0; q < len; q++ ){
+		if( !A::valid( p[q] ) )
+			return STREE_ALPHA_NIL;
+	}
+	typename A::pattern pat( p, len );
+	for( node = 0, q = 0; q < len; node = ch ){
+		if( ( ch = stree_alpha_child_of( t, node, pat.get( q ) ) ) == STREE_ALPHA_NIL )
+			return STREE_ALPHA_NIL;
+		/* a leaf edge ends with the sentinel, which no pattern has */
+		leaf = ( t->is_sent[( t->end[ch] - 1 ) >> 6] >> ( ( t->end[ch] - 1 ) & 63 ) ) & 1;
+		avail = t->end[ch] - t->start[ch] - leaf;
+		m = len - q < avail ? len - q : avail;
+		if( t->text.match( t->start[ch], pat, q, m ) < m )
+			return STREE_ALPHA_NIL;
+		q += m;
+		if( q < len && leaf && m == avail )
+			return STREE_ALPHA_NIL;
+	}
+	return node;
+}
+
+/* The number of occurrences of a pattern, after stree_alpha_finish */
+template< class A >
+unsigned int stree_alpha_count( const stree_alpha_tree< A > *t, const typename A::symbol *p, unsigned int len )
+{
+	unsigned int node = stree_alpha_find( t, p, len );
+	return node == STREE_ALPHA_NIL ? 0 : t->leaves[node];
+}
+
+/* The occurrences of a pattern, after stree_alpha_finish
+* Parameter:  t:      the tree
+*             p, len: the pattern
+*             occ:    the first occurrence, in leaf order (for return)
+* Return:     the number of occurrences, from *occ on
+* Last modified: 10/18/2026
+*/
+template< class A >
+unsigned int stree_alpha_occurrences( const stree_alpha_tree< A > *t, const typename A::symbol *p,
+	unsigned int len, const stree_alpha_occ **occ )
+{
+	unsigned int node = stree_alpha_find( t, p, len );
+	*occ = NULL;
+	if( node == STREE_ALPHA_NIL || t->leaves[node] == 0 )
+		return 0;
+	*occ = &t->occ[t->occ_begin[node]];
+	return t->leaves[node];
+}
+
+/* The bytes held by a tree */
+template< class A >
+size_t stree_alpha_memory( const stree_alpha_tree< A > *t )
+{
+	return t->text.bytes() + ( t->sent.capacity() + t->start.capacity() + t->end.capacity() +
+		t->link.capacity() + t->leaves.capacity() + t->occ_begin.capacity() ) * sizeof( unsigned int ) +
+		t->occ.capacity() * sizeof( stree_alpha_occ ) +
+		t->is_sent.capacity() * sizeof( unsigned long long ) +
+		t->child.capacity() * sizeof( stree_alpha_child< A > );
+}
+
+/* Release a tree */
+template< class A >
+void stree_alpha_free( stree_alpha_tree< A > *t )
+{
+	stree_alpha_tree< A > empty;
+	swap( *t, empty );
+}
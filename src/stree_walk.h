@@ -0,0 +1,160 @@
+#pragma once
+
+#include "suffix_tree.h"
+#include <vector>
+
+/* Non-recursive walks of a SUFFIXTREE.
+*
+* The subtree of a node is walked depth first with an explicit
+* stack, so a deep tree costs heap memory rather than call stack.
+* The visitor is a template parameter and its calls are inlined.
+*
+* stree_walk is the Euler tour: visitor.enter( node ) as the walk
+* comes down to a node, visitor.leave( node ) as it goes back up,
+* after the whole subtree. enter returns STREE_WALK_NEXT to go on
+* below the node, STREE_WALK_SKIP to leave its subtree out (leave is
+* still called) or STREE_WALK_STOP to end the walk at once.
+* stree_walk_pre and stree_walk_post take a single function, called
+* before or after the subtree.
+*
+* stree_walk_paths passes also the path of each node, the characters
+* from the root down, kept in one buffer that each edge label is
+* copied into once. The path is 0-terminated and only valid during
+* the call. The leaves of a string open in an STREE_BUILDER are
+* walked with the characters appended so far.
+*/
+
+#define STREE_WALK_NEXT  0
+#define STREE_WALK_SKIP  1
+#define STREE_WALK_STOP  2
+
+/* Walk the subtree of root
+* Return:     1 if the visitor stopped the walk, 0 otherwise
+*/
+template< class V >
+int stree_walk( NODE *root, V &visitor )
+{
+	vector< pair< NODE *, CHILD_STRUCT * > > stack;
+	CHILD_STRUCT *c;
+	NODE *node;
+	int act;
+
+	if( ( act = visitor.enter( root ) ) == STREE_WALK_STOP )
+		return 1;
+	stack.push_back( make_pair( root, act == STREE_WALK_SKIP ? ( CHILD_STRUCT * )NULL : root->children ) );
+	while( !stack.empty() ){
+		if( ( c = stack.back().second ) != NULL ){
+			stack.back().second = c->next;
+			if( ( act = visitor.enter( c->child ) ) == STREE_WALK_STOP )
+				return 1;
+			stack.push_back( make_pair( c->child, act == STREE_WALK_SKIP ? ( CHILD_STRUCT * )NULL : c->child->children ) );
+			continue;
+		}
+		node = stack.back().first;
+		stack.pop_back();
+		visitor.leave( node );
+	}
+	return 0;
+}
+
+template< class F >
+struct stree_walk_pre_visitor{
+	F &fn;
+	stree_walk_pre_visitor( F &f ) : fn( f ){}
+	int enter( NODE *node ){ return fn( node ); }
+	void leave( NODE * ){}
+};
+
+template< class F >
+struct stree_walk_post_visitor{
+	F &fn;
+	stree_walk_post_visitor( F &f ) : fn( f ){}
+	int enter( NODE * ){ return STREE_WALK_NEXT; }
+	void leave( NODE *node ){ fn( node ); }
+};
+
+/* Call fn( node ) before the subtree of each node; it returns the
+* STREE_WALK_* action
+* Return:     1 if fn stopped the walk, 0 otherwise
+*/
+template< class F >
+int stree_walk_pre( NODE *root, F &fn )
+{
+	stree_walk_pre_visitor< F > v( fn );
+	return stree_walk( root, v );
+}
+
+/* Call fn( node ) after the subtree of each node, children first */
+template< class F >
+void stree_walk_post( NODE *root, F &fn )
+{
+	stree_walk_post_visitor< F > v( fn );
+	stree_walk( root, v );
+}
+
+/* The path of a node into buf, from the root down
+* Return:     the length of the path
+*/
+inline unsigned int stree_walk_path_of( SUFFIXTREE *tree, NODE *node, vector< char > &buf )
+{
+	NODE *p;
+	unsigned int len, edgelen;
+	for( p = node, len = 0; p->parent != p; p = p->parent )
+		len += EDGE_LENGTH( tree, p );
+	buf.resize( len + 1 );
+	buf[len] = 0;
+	for( p = node; p->parent != p; p = p->parent ){
+		edgelen = EDGE_LENGTH( tree, p );
+		len -= edgelen;
+		if( edgelen > 0 )
+			memcpy( &buf[len], p->start_char, edgelen );
+	}
+	return buf.size() - 1;
+}
+
+/* The Euler tour of stree_walk with the paths:
+* visitor.enter( node, path, len ) and visitor.leave( node, path, len )
+* Return:     1 if the visitor stopped the walk, 0 otherwise
+*/
+template< class V >
+int stree_walk_paths( SUFFIXTREE *tree, NODE *root, V &visitor )
+{
+	vector< pair< NODE *, CHILD_STRUCT * > > stack;
+	vector< unsigned int > depth;       /*the path length of each open node*/
+	vector< char > path;
+	CHILD_STRUCT *c;
+	NODE *node;
+	unsigned int len, edgelen;
+	int act;
+
+	len = stree_walk_path_of( tree, root, path );
+	if( ( act = visitor.enter( root, &path[0], len ) ) == STREE_WALK_STOP )
+		return 1;
+	stack.push_back( make_pair( root, act == STREE_WALK_SKIP ? ( CHILD_STRUCT * )NULL : root->children ) );
+	depth.push_back( len );
+	while( !stack.empty() ){
+		if( ( c = stack.back().second ) != NULL ){
+			stack.back().second = c->next;
+			node = c->child;
+			edgelen = EDGE_LENGTH( tree, node );
+			len = depth.back() + edgelen;
+			if( path.size() <= len )
+				path.resize( 2 * len + 1 );
+			if( edgelen > 0 )
+				memcpy( &path[depth.back()], node->start_char, edgelen );
+			path[len] = 0;
+			if( ( act = visitor.enter( node, &path[0], len ) ) == STREE_WALK_STOP )
+				return 1;
+			stack.push_back( make_pair( node, act == STREE_WALK_SKIP ? ( CHILD_STRUCT * )NULL : node->children ) );
+			depth.push_back( len );
+			continue;
+		}
+		node = stack.back().first;
+		len = depth.back();
+		stack.pop_back();
+		depth.pop_back();
+		path[len] = 0;
+		visitor.leave( node, &path[0], len );
+	}
+	return 0;
+}
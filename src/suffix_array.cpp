@@ -0,0 +1,492 @@
+#include "suffix_array.h"
+#include <vector>
+
+#define SAIS_EMPTY  -1
+#define SAIS_LMS( t, i )  ( ( i ) > 0 && ( t )[i] && !( t )[( i ) - 1] )
+
+/* Set bkt[c] to the start (or the end) of the bucket of character c */
+static void sais_buckets( const int *s, int *bkt, int n, int k, int end )
+{
+	int i, sum;
+	memset( ( void * )bkt, 0, sizeof( int ) * k );
+	for( i = 0; i < n; i++ )
+		bkt[s[i]]++;
+	for( i = 0, sum = 0; i < k; i++ ){
+		sum += bkt[i];
+		bkt[i] = end ? sum : sum - bkt[i];
+	}
+}
+
+/* Induce the order of the L-type suffixes from the sorted ones */
+static void sais_induce_l( const char *t, int *sa, const int *s, int *bkt, int n, int k )
+{
+	int i, j;
+	sais_buckets( s, bkt, n, k, 0 );
+	for( i = 0; i < n; i++ ){
+		j = sa[i] - 1;
+		if( sa[i] > 0 && !t[j] )
+			sa[bkt[s[j]]++] = j;
+	}
+}
+
+/* Induce the order of the S-type suffixes from the sorted ones */
+static void sais_induce_s( const char *t, int *sa, const int *s, int *bkt, int n, int k )
+{
+	int i, j;
+	sais_buckets( s, bkt, n, k, 1 );
+	for( i = n - 1; i >= 0; i-- ){
+		j = sa[i] - 1;
+		if( sa[i] > 0 && t[j] )
+			sa[--bkt[s[j]]] = j;
+	}
+}
+
+/* Sort the suffixes of s by induced sorting (SA-IS) in O(n). The
+* last character of s must be a unique 0.
+* Parameter:  s:  the text, characters in [0, k)
+*             sa: the suffix array (for return), n entries
+*             n:  the length of s, at least 2
+*             k:  the size of the alphabet
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+static int sais( const int *s, int *sa, int n, int k )
+{
+	char *t;
+	int *bkt, *s1, *sa1;
+	int i, j, d, n1, name, pos, prev, diff, ret;
+
+	t = ( char * )malloc( n );
+	bkt = ( int * )malloc( sizeof( int ) * k );
+	if( t == NULL || bkt == NULL ){
+		free( t );
+		free( bkt );
+		return 1;
+	}
+	/* classify the suffixes: t[i] is 1 for S-type, 0 for L-type */
+	t[n-1] = 1;
+	t[n-2] = 0;
+	for( i = n - 3; i >= 0; i-- )
+		t[i] = s[i] < s[i+1] || ( s[i] == s[i+1] && t[i+1] );
+
+	/* sort the LMS substrings */
+	sais_buckets( s, bkt, n, k, 1 );
+	for( i = 0; i < n; i++ )
+		sa[i] = SAIS_EMPTY;
+	for( i = 1; i < n; i++ ){
+		if( SAIS_LMS( t, i ) )
+			sa[--bkt[s[i]]] = i;
+	}
+	sais_induce_l( t, sa, s, bkt, n, k );
+	sais_induce_s( t, sa, s, bkt, n, k );
+
+	/* name them, equal substrings getting equal names */
+	for( i = 0, n1 = 0; i < n; i++ ){
+		if( SAIS_LMS( t, sa[i] ) )
+			sa[n1++] = sa[i];
+	}
+	for( i = n1; i < n; i++ )
+		sa[i] = SAIS_EMPTY;
+	for( i = 0, name = 0, prev = -1; i < n1; i++ ){
+		pos = sa[i];
+		diff = 0;
+		for( d = 0; d < n; d++ ){
+			if( prev == -1 || s[pos+d] != s[prev+d] || t[pos+d] != t[prev+d] ){
+				diff = 1;
+				break;
+			}
+			if( d > 0 && ( SAIS_LMS( t, pos + d ) || SAIS_LMS( t, prev + d ) ) )
+				break;
+		}
+		if( diff ){
+			name++;
+			prev = pos;
+		}
+		sa[n1 + pos / 2] = name - 1;
+	}
+	for( i = n - 1, j = n - 1; i >= n1; i-- ){
+		if( sa[i] >= 0 )
+			sa[j--] = sa[i];
+	}
+
+	/* sort the LMS suffixes, recursing while the names are not unique */
+	s1 = sa + n - n1;
+	sa1 = sa;
+	ret = 0;
+	if( name < n1 )
+		ret = sais( s1, sa1, n1, name );
+	else{
+		for( i = 0; i < n1; i++ )
+			sa1[s1[i]] = i;
+	}
+
+	/* induce the whole array from the sorted LMS suffixes */
+	if( ret == 0 ){
+		sais_buckets( s, bkt, n, k, 1 );
+		for( i = 1, j = 0; i < n; i++ ){
+			if( SAIS_LMS( t, i ) )
+				s1[j++] = i;
+		}
+		for( i = 0; i < n1; i++ )
+			sa1[i] = s1[sa1[i]];
+		for( i = n1; i < n; i++ )
+			sa[i] = SAIS_EMPTY;
+		for( i = n1 - 1; i >= 0; i-- ){
+			j = sa[i];
+			sa[i] = SAIS_EMPTY;
+			sa[--bkt[s[j]]] = j;
+		}
+		sais_induce_l( t, sa, s, bkt, n, k );
+		sais_induce_s( t, sa, s, bkt, n, k );
+	}
+	free( t );
+	free( bkt );
+	return ret;
+}
+
+/* Compute sa and lcp for the text of the array. The 0 ending
+* string i is mapped to the unique character i, so no common
+* prefix runs from one string into the next.
+* Last modified:  10/18/2026
+*/
+
+static int sarr_index( SUFFIXARRAY *sa )
+{
+	int *s, *order;
+	unsigned int i, id, n, h, p, q;
+
+	n = sa->text_len;
+	s = ( int * )malloc( sizeof( int ) * ( n + 1 ) );
+	order = ( int * )malloc( sizeof( int ) * ( n + 1 ) );
+	sa->lcp = ( unsigned int * )malloc( sizeof( unsigned int ) * n );
+	if( s == NULL || order == NULL || sa->lcp == NULL ){
+		free( s );
+		free( order );
+		return 1;
+	}
+	for( i = 0, id = 1; i < n; i++ ){
+		if( sa->text[i] == 0 )
+			s[i] = id++;
+		else
+			s[i] = sa->strnum + 1 + ( unsigned char )sa->text[i];
+	}
+	s[n] = 0;
+	if( sais( s, order, n + 1, sa->strnum + 257 ) ){
+		free( s );
+		free( order );
+		return 1;
+	}
+	/* drop the sentinel, which sorts first */
+	memmove( order, order + 1, sizeof( int ) * n );
+	sa->sa = ( unsigned int * )order;
+
+	/* Kasai: s becomes the rank of each suffix */
+	for( i = 0; i < n; i++ )
+		s[sa->sa[i]] = i;
+	for( p = 0, h = 0; p < n; p++ ){
+		if( s[p] == 0 ){
+			sa->lcp[0] = 0;
+			h = 0;
+			continue;
+		}
+		q = sa->sa[s[p] - 1];
+		while( sa->text[p+h] != 0 && sa->text[p+h] == sa->text[q+h] )
+			h++;
+		sa->lcp[s[p]] = h;
+		if( h > 0 )
+			h--;
+	}
+	free( s );
+	return 0;
+}
+
+/* Build the suffix array of a set of strings with SA-IS
+* Parameter:  sa:      the SUFFIXARRAY to fill
+*             strings: the strings, which must not contain a 0
+*             num:     the number of strings, getting IDs 1 .. num
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_build( SUFFIXARRAY *sa, char **strings, unsigned int num )
+{
+	unsigned int i, len;
+
+	memset( ( void * )sa, 0, sizeof( SUFFIXARRAY ) );
+	if( num == 0 )
+		return 1;
+	if( ( sa->str_offset = ( unsigned int * )malloc( sizeof( unsigned int ) * ( num + 1 ) ) ) == NULL )
+		return 1;
+	sa->strnum = num;
+	sa->str_offset[0] = 0;
+	for( i = 0; i < num; i++ )
+		sa->str_offset[i+1] = sa->str_offset[i] + strlen( strings[i] ) + 1;
+	sa->text_len = sa->str_offset[num];
+	if( ( sa->text = ( char * )malloc( sa->text_len ) ) == NULL ){
+		sarr_free( sa );
+		return 1;
+	}
+	for( i = 0; i < num; i++ ){
+		len = sa->str_offset[i+1] - sa->str_offset[i];
+		memcpy( sa->text + sa->str_offset[i], strings[i], len );
+	}
+	if( sarr_index( sa ) ){
+		sarr_free( sa );
+		return 1;
+	}
+	return 0;
+}
+
+/* Build the suffix array of the strings of a tree. The string
+* IDs are kept and the SUFFIXTREE is not modified; of a sliding
+* window, only the live strings are kept, numbered from 1 as after
+* stree_window_compact.
+* Parameter:  sa:   the SUFFIXARRAY to fill
+*             tree: the SUFFIXTREE
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_from_tree( SUFFIXARRAY *sa, SUFFIXTREE *tree )
+{
+	unsigned int i, dead;
+
+	memset( ( void * )sa, 0, sizeof( SUFFIXARRAY ) );
+	if( tree->strnum == tree->str_evicted )
+		return 1;
+	dead = tree->str_offset[tree->str_evicted];
+	sa->strnum = tree->strnum - tree->str_evicted;
+	sa->text_len = tree->text_len - dead;
+	if( ( sa->text = ( char * )malloc( sa->text_len ) ) == NULL ||
+		( sa->str_offset = ( unsigned int * )malloc( sizeof( unsigned int ) * ( sa->strnum + 1 ) ) ) == NULL ){
+		sarr_free( sa );
+		return 1;
+	}
+	memcpy( sa->text, tree->text + dead, sa->text_len );
+	for( i = 0; i <= sa->strnum; i++ )
+		sa->str_offset[i] = tree->str_offset[i + tree->str_evicted] - dead;
+	if( sarr_index( sa ) ){
+		sarr_free( sa );
+		return 1;
+	}
+	return 0;
+}
+
+/* Insert the strings of the array into a tree, for the algorithms
+* that need suffix links. The strings keep their IDs when the tree
+* is empty.
+* Parameter:  sa:   the SUFFIXARRAY
+*             tree: the SUFFIXTREE
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_to_tree( SUFFIXARRAY *sa, SUFFIXTREE *tree )
+{
+	unsigned int i;
+	for( i = 0; i < sa->strnum; i++ ){
+		if( stree_insert_string_len( tree, sa->text + sa->str_offset[i],
+			sa->str_offset[i+1] - sa->str_offset[i] - 1 ) )
+			return 1;
+	}
+	return 0;
+}
+
+void sarr_free( SUFFIXARRAY *sa )
+{
+	free( sa->text );
+	free( sa->str_offset );
+	free( sa->sa );
+	free( sa->lcp );
+	memset( ( void * )sa, 0, sizeof( SUFFIXARRAY ) );
+}
+
+size_t sarr_memory_usage( SUFFIXARRAY *sa )
+{
+	return sa->text_len + sizeof( unsigned int ) * ( sa->strnum + 1 )
+		+ 2 * sizeof( unsigned int ) * ( size_t )sa->text_len;
+}
+
+/* Get the ID of the string holding a text position
+* Last modified:  10/18/2026
+*/
+
+unsigned int sarr_string_id( SUFFIXARRAY *sa, unsigned int pos )
+{
+	return upper_bound( sa->str_offset, sa->str_offset + sa->strnum + 1, pos ) - sa->str_offset;
+}
+
+/* Compare the suffix at pos with the first len characters of string
+* Return:     <0, 0 or >0 as the suffix sorts before, with or after
+*             the strings starting with them
+*/
+
+static int sarr_compare( SUFFIXARRAY *sa, unsigned int pos, char *string, unsigned int len )
+{
+	unsigned int i;
+	unsigned char a, b;
+	for( i = 0; i < len; i++ ){
+		a = ( unsigned char )sa->text[pos+i];
+		b = ( unsigned char )string[i];
+		if( a == 0 || a != b )
+			return a < b ? -1 : 1;
+	}
+	return 0;
+}
+
+/* Find the suffixes starting with a string by binary search
+* Parameter:  sa:     the SUFFIXARRAY
+*             string: the query string
+*             len:    its length
+*             range:  the interval of the suffixes (for return),
+*                     stringid_num is not counted
+* Return:     0 if the string occurs, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_find( SUFFIXARRAY *sa, char *string, unsigned int len, SA_INTERVAL *range )
+{
+	unsigned int lo, hi, mid, first;
+
+	if( len == 0 || sa->text_len == 0 )
+		return 1;
+	for( lo = 0, hi = sa->text_len; lo < hi; ){
+		mid = lo + ( hi - lo ) / 2;
+		if( sarr_compare( sa, sa->sa[mid], string, len ) < 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	first = lo;
+	for( hi = sa->text_len; lo < hi; ){
+		mid = lo + ( hi - lo ) / 2;
+		if( sarr_compare( sa, sa->sa[mid], string, len ) <= 0 )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if( lo == first )
+		return 1;
+	range->lo = first;
+	range->hi = lo - 1;
+	range->depth = len;
+	range->stringid_num = 0;
+	range->embedding_num = lo - first;
+	return 0;
+}
+
+/* Print every occurrence of a string, like stree_query_string
+* Return:     0 if the string occurs, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_query_string( SUFFIXARRAY *sa, char *string )
+{
+	SA_INTERVAL range;
+	unsigned int i, id, pos;
+
+	if( sarr_find( sa, string, strlen( string ), &range ) )
+		return 1;
+	for( i = range.lo; i <= range.hi; i++ ){
+		pos = sa->sa[i];
+		id = sarr_string_id( sa, pos );
+		printf( "The corresponding suffix is\t\t %s\n Starts from index %d in string %d\n",
+			sa->text + pos, pos - sa->str_offset[id-1], id );
+	}
+	return 0;
+}
+
+/* Find the substrings that occur in at least min_sup strings,
+* like find_substring over a tree after fix_stringid. Every node
+* of the equivalent tree is visited once, bottom-up, by a stack
+* over the lcp array; the strings of a node are counted as its
+* occurrences less, for each pair of consecutive occurrences of
+* the same string, one at their lowest common node.
+* Parameter:  sa:          the SUFFIXARRAY
+*             min_sup:     the minimum number of strings
+*             output:      the nodes found (for return), room for
+*                          2 * text_len entries at most
+*             output_size: the number of nodes found (for return)
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int sarr_find_substring( SUFFIXARRAY *sa, int min_sup, SA_INTERVAL output[], int *output_size )
+{
+	/* an open node: its lcp value, left bound and repeated strings */
+	struct open_node{
+		unsigned int depth, lo, dup;
+	}top;
+	vector< struct open_node > stack;
+	vector< unsigned int > last;
+	unsigned int i, n, cur, lo, carry, id, len, l, h, m;
+
+	*output_size = 0;
+	n = sa->text_len;
+	if( n == 0 )
+		return 1;
+	last.assign( sa->strnum + 1, ( unsigned int )-1 );
+	top.depth = top.lo = top.dup = 0;
+	stack.push_back( top );
+	for( i = 0; i <= n; i++ ){
+		cur = i < n ? sa->lcp[i] : 0;
+		lo = i > 0 ? i - 1 : 0;
+		carry = 0;
+		while( cur < stack.back().depth ){
+			top = stack.back();
+			stack.pop_back();
+			top.dup += carry;
+			if( ( int )( i - top.lo - top.dup ) >= min_sup ){
+				output[*output_size].lo = top.lo;
+				output[*output_size].hi = i - 1;
+				output[*output_size].depth = top.depth;
+				output[*output_size].stringid_num = i - top.lo - top.dup;
+				output[*output_size].embedding_num = i - top.lo;
+				( *output_size )++;
+			}
+			lo = top.lo;
+			carry = top.dup;
+		}
+		if( cur > stack.back().depth ){
+			top.depth = cur;
+			top.lo = lo;
+			top.dup = carry;
+			stack.push_back( top );
+		}
+		else
+			stack.back().dup += carry;
+		if( i == n )
+			break;
+
+		/* the leaf i, unless its suffix ends inside an open node */
+		id = sarr_string_id( sa, sa->sa[i] );
+		len = sa->str_offset[id] - sa->sa[i] - 1;
+		if( min_sup <= 1 && len > cur && len > ( i + 1 < n ? sa->lcp[i+1] : 0 ) ){
+			output[*output_size].lo = output[*output_size].hi = i;
+			output[*output_size].depth = len;
+			output[*output_size].stringid_num = output[*output_size].embedding_num = 1;
+			( *output_size )++;
+		}
+		/* the deepest open node holding the previous occurrence */
+		if( len > 0 && last[id] != ( unsigned int )-1 ){
+			for( l = 0, h = stack.size(); h - l > 1; ){
+				m = ( l + h ) / 2;
+				if( stack[m].lo <= last[id] )
+					l = m;
+				else
+					h = m;
+			}
+			stack[l].dup++;
+		}
+		if( len > 0 )
+			last[id] = i;
+	}
+	return 0;
+}
+
+/* Get the substring of a node, like get_substring */
+string sarr_get_substring( SUFFIXARRAY *sa, SA_INTERVAL *s )
+{
+	return string( sa->text + sa->sa[s->lo], s->depth );
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "suffix_tree.h"
+
+/* Suffix array backend for read-mostly workloads.
+*
+* The strings are kept in one text buffer, each followed by a 0, as
+* in a SUFFIXTREE. sa lists every suffix of the text in lexicographic
+* order, and lcp[i] is the length of the longest common prefix of
+* the suffixes sa[i-1] and sa[i], never reaching past the 0 that ends
+* a string. Text, sa and lcp take 9 bytes per character.
+*
+* The nodes of the equivalent suffix tree are SA_INTERVALs: the
+* suffixes sa[lo] .. sa[hi] are those starting with the depth
+* characters at text[sa[lo]].
+*/
+
+typedef struct suffixarray{
+	unsigned int strnum;
+	unsigned int text_len;
+	char *text;
+	unsigned int *str_offset;   /*strnum+1 entries, string i starts at str_offset[i-1]*/
+	unsigned int *sa;           /*text_len entries*/
+	unsigned int *lcp;          /*text_len entries, lcp[0] is 0*/
+}SUFFIXARRAY;
+
+typedef struct sa_interval{
+	unsigned int lo;
+	unsigned int hi;
+	unsigned int depth;         /*the length of the substring*/
+	unsigned int stringid_num;  /*the number of strings it occurs in*/
+	unsigned int embedding_num; /*the number of occurrences*/
+}SA_INTERVAL;
+
+int sarr_build( SUFFIXARRAY *sa, char **strings, unsigned int num );
+int sarr_from_tree( SUFFIXARRAY *sa, SUFFIXTREE *tree );
+int sarr_to_tree( SUFFIXARRAY *sa, SUFFIXTREE *tree );
+void sarr_free( SUFFIXARRAY *sa );
+size_t sarr_memory_usage( SUFFIXARRAY *sa );
+unsigned int sarr_string_id( SUFFIXARRAY *sa, unsigned int pos );
+int sarr_find( SUFFIXARRAY *sa, char *string, unsigned int len, SA_INTERVAL *range );
+int sarr_query_string( SUFFIXARRAY *sa, char *string );
+int sarr_find_substring( SUFFIXARRAY *sa, int min_sup, SA_INTERVAL output[], int *output_size );
+string sarr_get_substring( SUFFIXARRAY *sa, SA_INTERVAL *s );
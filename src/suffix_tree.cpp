@@ -1,1354 +1,2827 @@
-#include "suffix_tree.h"
-
-char *node_name[3] = { "Internode", "Interleaf", "Leaf" };
-
-/* Allocate a new node 
-* Parameter:  type: INTERNODE | INTERLEAF | LEAF
-* Return:     the pointer to the new node
-*             NULL if fails
-* Last modified:  6/25/2002
-*/
-
-NODE *stree_alloc_node( int type )
-{
-	NODE *NewNode;
-
-	if( ( NewNode = ( NODE * ) malloc( sizeof( NODE ) ) ) != NULL ){
-		memset( ( void * )NewNode, 0, sizeof( NODE ) );
-		NewNode->node_type = type;
-		NewNode->stringid_num = 0;
-		NewNode->embedding_num = 0;
-	}
-	else{
-		printf( "Error: node allocation fail!" );
-	}
-	return NewNode;
-}
-
-/* Create a new CHILD_STRUCT
-* Parameter:  child: the corresponding child NODE
-*             next:  the next CHILD_STRUCT
-* Return:     pointer to the created CHILD_STRUCT
-*             NULL if fails
-* Last modified:  6/25/2002
-*/  
-
-CHILD_STRUCT *stree_new_child_struct( NODE *child, CHILD_STRUCT *next )
-{
-	CHILD_STRUCT *NewChild;
-
-	if( ( NewChild = ( CHILD_STRUCT * )malloc( sizeof( CHILD_STRUCT ) ) )!= NULL ){
-		NewChild->child = child;
-		NewChild->next = next;
-	}
-	else{
-		printf( "Error: child struct allocation fail!" );
-	}
-	return NewChild;
-}
-
-/* Create a new STRINGID 
-* Parameter:  str_id:    the ID of the new string
-*             str_start: the starting index of the new string
-*                        corresponding to the sequence on the 
-*                        path from the root to this node
-*             next:  the next STRINGID
-* Return:     pointer to the created STRINGID
-*             NULL if fails
-* Last modified:  6/25/2002
-*/  
-
-STRINGID *stree_new_string_struct( unsigned int str_id, unsigned int str_start, STRINGID *next)
-{
-	STRINGID *NewStr;
-
-	if( ( NewStr = ( STRINGID * ) malloc( sizeof( STRINGID ) ) ) != NULL){
-		NewStr->str_id = str_id;
-		NewStr->str_start = str_start;
-		NewStr->next = next;
-	}
-	else{
-		printf( "Error: String struct allocation fail!" );
-	}
-	return NewStr;
-}
-
-/* Create a new leaf or interleaf
-* Parameter:  str_id:      the ID of the new string
-*             str_start:   the starting index of the new string
-*                          corresponding to the sequence on the 
-*                          path from the root to this node
-*             edgelen:     the number of charaters on the edge
-*             char_depth:  the charater depth, which equals to
-*                          the length of the sequence on the 
-*                          path from the root to this node
-*             c:           pointer to the string on the edge
-*             isinterleaf: INTERLEAF or LEAF
-*             node_count:  the total number of nodes in tree
-* Return:     pointer to the created node, NULL if fails
-* Last modified:  6/26/2002
-*/
-
-NODE * stree_new_leaf( unsigned int str_id, unsigned int str_start,
-	unsigned int edgelen, unsigned int char_depth,
-	char *c, int isinterleaf, unsigned int *node_count)
-{
-	NODE *NewLeaf;
-	if( ( NewLeaf = stree_alloc_node( isinterleaf ? INTERLEAF : LEAF ) ) != NULL ){
-		if( ( NewLeaf->strings = ( STRINGID * ) malloc( sizeof( STRINGID ) ) ) != NULL ){
-			/*For INTERLEAF, the string on the edge is NULL */
-			NewLeaf->start_char = isinterleaf ? NULL : c;  
-			NewLeaf->edgelen = edgelen;
-			NewLeaf->char_depth = char_depth;
-			NewLeaf->strings->str_id = str_id;
-			NewLeaf->strings->str_start = str_start;
-			NewLeaf->stringid_num++;
-			NewLeaf->strings->next = NULL;
-			NewLeaf->node_num = ++( *node_count );
-		}
-	}
-	else{
-		printf( "Error: new leaf allocation fail!" );
-		free( NewLeaf );
-		NewLeaf = NULL;
-	}
-
-	return NewLeaf;
-}
-
-/* Create a new RAWSTRING
-* Parameter: len: the length of the raw string
-* Return:    the created RAWSTRING
-*            NULL, if fails
-* Last modified: 6/25/2002
-*/
-
-RAWSTRING *stree_alloc_rawstring( unsigned int len )
-{
-	RAWSTRING *t;
-	if( ( t = ( RAWSTRING * )malloc( sizeof( RAWSTRING ) ) ) != NULL ){
-		if( ( t->string = ( char * )malloc( sizeof( char )*len ) ) == NULL ){
-			free( t );
-			t = NULL;
-		}
-		else{ 
-			t->next = NULL;
-		}
-	}
-	return t;
-}
-
-
-/* Check if the string ID -str_id- already exists
-* in the node.
-* Parameter:  head:   the pointer to the string ID 
-*                     linked list of  the node.
-*             str_id: the string ID in search.
-*             slot:   the address of the return pointer
-*                     (used for return). 
-* Return:     0       If str_id in node
-*                     slot points to the STRINGID
-*                     of str_id in search
-*             1       otherwise
-*                     slot points to the place to
-*                     insert the new string ID
-* Last modified: 6/25/2002
-*/
-
-int stree_check_stringid( STRINGID *head, unsigned int str_id, STRINGID **slot)
-{
-	STRINGID *p,*t;
-	t = head;
-	if( str_id == 0 ) 
-		return 0;
-	/* When the ID need not to be checked */
-	while( t != NULL && t->str_id < str_id ){
-		p = t;
-		t = t->next;
-	}
-	if( t != NULL && t->str_id == str_id ){
-		*slot = t;
-		return 0;
-	}
-	*slot = p;
-	return 1;
-}
-
-/* Get the CHILD_STRUCT of the child node whose
-* edge starts with character c
-* Parameter:  parent: the parent node
-*             c:      the starting character
-* Return:     pointer to the CHILD_STRUCT if there
-*             is an edge starts with c from parent,
-*             NULL otherwise. 
-* Last modified: 6/25/2002
-*/
-
-CHILD_STRUCT * stree_get_child( NODE *parent, char c )
-{
-	CHILD_STRUCT *t;
-	SKIP_INTERLEAF
-		while( t != NULL && t->child->start_char[0] != c )
-			t = t->next;
-	return t;
-}
-
-/* Insert the child node into the parent node
-* Parameter:  parent:     the parent node 
-*             child:      the node to be inserted
-*             node_count: the total number of nodes in the tree 
-* Return:     If the node with the string ID already exists,return
-*             it and free child.Otherwise, return the new inserted
-*             node. If fails, return NULL
-* Last modified: 6/27/2002
-*/
-
-NODE * stree_insert_child( NODE *parent, NODE *child, unsigned int *node_count)
-{
-	CHILD_STRUCT *newChild, *p, *t;
-	STRINGID *s, *snew;
-
-	if( child->start_char == NULL ){  
-		/* the child node is INTERLEAF */
-		if( parent->children->child->node_type != INTERLEAF ){ 
-			/*No INTEALEAF in the parent node. (A node has only oneINTERLEAF child node) */
-			if( ( newChild = stree_new_child_struct( child, parent->children ) ) == NULL )  
-				return NULL;
-			parent->children = newChild;
-			child->parent = parent;
-			return child;
-		}
-		/* INTERLEAF exists, check string ID */
-		if( stree_check_stringid( parent->children->child->strings, child->strings->str_id, &s ) ){
-			if( ( snew = stree_new_string_struct( child->strings->str_id, child->strings->str_start, s->next ) ) == NULL){
-				return NULL;
-			}
-			s->next = snew;
-			parent->stringid_num++;
-		}
-		free( child );
-		( *node_count )--;
-		return parent->children->child;
-	}
-
-	/* the child node is a normal LEAF, check if it already exists */
-	p = NULL;
-	SKIP_INTERLEAF
-		while( t != NULL && t->child->start_char[0] < child->start_char[0] ){
-			p = t;
-			t = t->next;
-		}
-		if( t != NULL && t->child->start_char[0] == child->start_char[0] && 
-			stree_check_stringid( t->child->strings, child->strings->str_id, &s ) ){
-				if( ( snew = stree_new_string_struct( child->strings->str_id, child->strings->str_start, s->next ) ) == NULL){
-					return NULL;
-				}
-				s->next = snew;
-				parent->stringid_num++;
-				free( child );
-				( *node_count )--;
-				return t->child;
-		}
-		/* Does not exist, insert into parent node */
-		if( ( newChild = stree_new_child_struct( child, t ) ) == NULL ){
-			return NULL;
-		}
-		if( p == NULL ){
-			parent->children = newChild;
-		}
-		else{
-			p->next = newChild;
-		}
-		child->parent = parent;
-		return child;
-}
-
-/* Split the edge of child and link node onto it
-* Parameter:  node:       the node to be linked
-*             child:      the node whose edge is to be split
-*             edgeindex:  the index when the last charater
-*                         check failed 
-*             node_count: the total number of nodes in tree
-* Return:     0   if successful, 1 otherwise
-* Last modified: 6/27/2002
-*/ 
-
-int stree_link_node( NODE *node, NODE *child, unsigned int edgeindex, unsigned int *node_count)
-{
-	CHILD_STRUCT *t;
-	NODE *parent;
-	assert( ( parent = child->parent ) );
-	if( stree_insert_child( node, child, node_count ) == NULL )   
-		return 1;
-
-	/*find the pointer in the parent that points to the
-	child and modify it */
-	t = stree_get_child( parent, child->start_char[0] );
-	assert( t );
-	//  if(stree_add_stringid(&node->strings,child->strings)) return 1;
-	t->child = node;
-	node->start_char = child->start_char;
-	node->edgelen = edgeindex + 1;
-	node->char_depth = child->char_depth - child->edgelen + node->edgelen;
-	node->parent = parent;
-	node->node_num = ++( *node_count );
-	//node->stringid_num = child->stringid_num + 1; 
- 
-	child->start_char = &( child->start_char[edgeindex+1] );
-	child->edgelen -= node->edgelen;
-	//  if (child->edgelen==0) child->node_type=INTERLEAF;
-	return 0;
-}
-
-/* Check if character c exists on the edge of
-* the parent node when the current index is in
-* the middle of the edge, or if c exists on any
-* path under parent node when the current index
-* is the last character of the edge.
-* Parameter: parent:    the node to be checked
-*            newnode:   the node where c exists
-*            edgeindex: the current index
-*            newindex:  the index of c
-*            str_id:    the ID of the string in search
-*            c:         the character in search
-* Return:    0   c is found with the correct string id
-*            1   c is found, but with wrong string id
-*            2   c is not found
-* Last modified: 6/27/2002
-*/
-
-int stree_check_next(NODE *parent, NODE **newnode,
-	int edgeindex, int *newindex, unsigned int str_len,
-	unsigned int str_id, char c)
-{
-	CHILD_STRUCT *t;
-	STRINGID *temp;
-
-	if( edgeindex >= ( int )parent->edgelen - 1 ){ 
-		/* the current index is the last character */
-		if( parent->node_type == LEAF && c == 0 ) 
-			return 1;
-		t = parent->children;
-		if( t != NULL && c == 0 ){ 
-			/* the character in search is the null ending symbol */
-			if( t->child->node_type == INTERLEAF || ( t->child->node_type == LEAF && t->child->edgelen == 0 ) ){
-				return stree_check_stringid( t->child->strings, str_id, &temp );
-			}
-		}
-		t = stree_get_child( parent, c );
-		/* For INTERNODE, don't check string ID. The string ID 
-		consistency will be fixed after the whole string is added */
-		if( t == NULL || ( t->child->node_type == INTERLEAF && stree_check_stringid( t->child->strings, str_id, &temp ) ) )  
-			return 2;
-		/* the new index is the first character on the corresponding edge */
-		*newnode = t->child;
-		*newindex = 0;
-		return 0;
-	}
-	/* the current index is in the middle of the edge,
-	check the next character on the edge */
-	if( parent->start_char[edgeindex+1] != c )   
-		return 2;
-	*newindex = edgeindex + 1;
-	*newnode = parent;
-	return 0;
-}
-
-/* walk down the path from the start node according to the string 
-* Parameter:  start:  the node under which the walk starts
-*             string: the query string
-*             len:    the number of characters to walk
-*             str_id: the ID of the string
-* Return:     the node on whose edge the walk ends,
-*             NULL if the string is empty or len less than 1
-* Last modified: 6/27/2002
-*/
-
-NODE * stree_walk_down( NODE *start, char *string, unsigned int len, unsigned int str_id )
-{
-	unsigned int i;
-	int n;
-	NODE *p,*t;
-	if( string == NULL && len < 1 ) 
-		return NULL;
-	for( i = 0, n = start->edgelen - 1, p = start; i < len; i++, p = t ){
-		if( stree_check_next( p, &t, n, &n, len, str_id, string[i] ) )
-			return NULL;
-	}
-	return p;
-}
-
-NODE * stree_walk_and_fill( NODE *start, char *string, unsigned int len, int *s, int size )
-{
-	unsigned int i;
-	int n;
-	NODE *p, *t;
-	if( string == NULL && len < 1 ) 
-		return NULL;
-	for( i = 0 , n = start->edgelen - 1, p = start; i < len; i++, p = t ){
-		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) )
-			return NULL;
-		if( n == t->edgelen - 1 ){
-			if( t->node_type == LEAF || t->children->child->node_type == INTERLEAF ){
-				s[size-i-1] = TRUE;
-			}
-		}		  
-	}
-	if( n == t->edgelen - 1 && t->node_type == LEAF )
-		return NULL;
-	return p;
-}	
-
-NODE * stree_walk_and_report( NODE *start, char *string,
-	unsigned int len, int *s, int size, int nid)
-{
-	unsigned int i;
-	int n;
-	NODE *p, *t;
-	if( string == NULL && len < 1 ) 
-		return NULL;
-	for( i = 0, n = start->edgelen - 1, p = start; i < len; i++, p = t ){
-		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) )
-			return NULL;
-		if( n == t->edgelen - 1 ){
-			if( t->node_type == LEAF || t->children->child->node_type == INTERLEAF ){
-				if( s[i+1] == TRUE ){
-					printf( "The pattern occurs at index %d in node %d\n", size - i, nid );
-				}
-			}
-		}		  
-	}
-	if( n == t->edgelen - 1 && t->node_type == LEAF )
-		return NULL;
-	return p;
-}	
-
-/* the skip-count trick used in the tree construction.
-* similar to stree_walk_down, but no string ID check
-* and matching on a edge base
-* Parameter:  start:     the node under which the match starts
-*             string:    the query string
-*             edgeindex: pointer to new edge index (for return)
-*             len:       the number of characters to match
-* Return:     the node on whose edge the match ends and set
-*             the corresponding edge index
-* Last modified: 6/27/2002
-*/
-
-NODE * stree_skip_count( NODE *start, char *string, int *edgeindex, int len )
-{
-	int n, i;
-	NODE *p, *t;
-	assert( string != NULL );
-	if( len <= 0 ){
-		*edgeindex = start->edgelen - 1;
-		return start;
-	}
-	for( i = 0, n = start->edgelen - 1, p = start;	i < len; i += t->edgelen, p = t, n = t->edgelen - 1 ){
-		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) == 2 ) 
-			break;
-	}
-	*edgeindex = p->edgelen - ( i - len ) - 1;
-	return p;
-}
-
-/* the follow suffix link trick used in the tree construction
-* Parameter: last:      the new leaf or new internode
-*            edgeindex: the current edge index 
-* Return:    the node where the next query should start with
-*            and set the corresponding current edge index
-* Last modified: 6/27/2002
-*/
-
-NODE * stree_follow_suffix( NODE *last, int *edgeindex )
-{
-	NODE *s, *child, *parent;
-	parent = last->parent;
-	s = parent->suffix_link;
-	if( last->node_type != INTERNODE ){ 
-		/* if a new leaf or interleaf, always query from the 
-		internode to which th suffix link points */ 
-		child = s;
-		*edgeindex = s->edgelen - 1;
-	}
-	else{
-		if( parent->char_depth != s->char_depth ){
-			/* if parent is not the root */
-			child = stree_skip_count( s, last->start_char, edgeindex, last->edgelen );
-		}
-		else{
-			child = stree_skip_count( s, last->start_char + 1, edgeindex, last->edgelen - 1 );
-		}
-	}
-	return child;
-}
-
-/* Find the last slot to insert a new raw string
-* Parameter:  head: the head of the linked list
-* Return:     pointer to the last RAWSTRING 
-* Last modified: 6/25/2002
-*/
-
-RAWSTRING * stree_find_last( RAWSTRING *head )
-{
-	RAWSTRING *t;
-	for( t = head; t->next != NULL; t = t->next );
-	return t;
-}  
-
-/* Insert a new string into the suffix tree.
-* Parameter: tree:   the SUFFIXTREE 
-*            string: the new string
-* Return:    If successful, return 0.
-*            Otherwise, return 1.
-* Last modified: 6/27/2002
-*/
-
-int stree_insert_string( SUFFIXTREE *tree, char *string )
-{
-	int i, j, len, tag, p;
-	int edgeindex, lastindex, depth, newindex;
-	NODE *lastnode, *suffix_update, *childnode, *newleaf, *newnode;
-	RAWSTRING *last;
-	STRINGID *temp;
-
-	if( tree->strnum == 0 ){/* no string exists, create new tree */
-		if( ( tree->root = stree_alloc_node( INTERNODE ) ) == NULL ) 
-			return 1; 
-		tree->root->suffix_link = tree->root->parent = tree->root;
-		tree->node_count = tree->root->node_num = 1;
-		if( ( last = tree->raw = stree_alloc_rawstring( strlen( string ) + 1 ) ) == NULL ){ 
-			free( tree->root );
-			return 1;
-		}
-	}
-	else{
-		last = stree_find_last( tree->raw );
-		if( ( last->next = stree_alloc_rawstring( strlen( string ) + 1 ) ) == NULL ) 
-			return 1;
-		last = last->next;
-	}
-	strncpy( last->string, string, strlen( string ) );
-	last->string[strlen( string )] = 0;
-	tree->strnum++;
-
-	len = strlen( last->string );
-	lastnode = tree->root;
-	lastindex = 0;
-	edgeindex = -1;
-	suffix_update = NULL;
-	for( i = 0; i <= len; i++ ){
-		if( i == len && lastnode == tree->root && edgeindex == -1 ){
-			break;
-		}
-		tag = 0;
-		for( j = lastindex; j <= i; j++ ){
-			if( j == len ){
-				if(	tag && suffix_update != NULL ){
-					suffix_update->suffix_link = lastnode;
-				}
-				break;
-			}
-
-			if( ( p = stree_check_next( lastnode, &childnode, edgeindex, &newindex,
-				len, tree->strnum, last->string[i] ) ) == 0 ){ /*in tree */
-					if( tag && suffix_update != NULL ){
-						suffix_update->suffix_link = lastnode;
-						tag = 0;
-					}
-					edgeindex = newindex;
-					lastnode = childnode;
-					break;
-			}
-			else{ 
-				if( p == 1 ){
-					if( lastnode->node_type == LEAF ){
-						assert( stree_check_stringid( lastnode->strings, tree->strnum, &temp ) == 1 );
-						lastnode->stringid_num++;
-					}
-					else{
-						assert( stree_check_stringid( lastnode->children->child->strings,
-							tree->strnum, &temp ) == 1 );
-						lastnode->children->child->stringid_num++; 
-					}
-					temp->next = (STRINGID *)malloc( sizeof( STRINGID ) );
-					temp->next->str_id = tree->strnum;
-					temp->next->str_start = len - lastnode->char_depth;
-					temp->next->next = NULL;
-					if( tag && suffix_update != NULL ){
-						suffix_update->suffix_link = lastnode;
-						tag = 0;
-					}
-				}
-				else{
-					if( edgeindex >= ( int )lastnode->edgelen - 1 ){
-						depth = len - j - lastnode->char_depth;
-					}
-					else{
-						depth = len - j - lastnode->char_depth + lastnode->edgelen - edgeindex - 1;
-					}
-
-					if( ( newleaf = stree_new_leaf( tree->strnum, j, i == len ? 0 : depth, len-j,
-						&last->string[len - depth], i == len, &tree->node_count ) ) == NULL ){
-							return 1;
-					}
-
-					if( edgeindex < ( int ) lastnode->edgelen - 1 || lastnode->node_type == LEAF ){
-						if( ( newnode = stree_alloc_node( INTERNODE ) ) == NULL ) 
-							return 1;
-						stree_link_node( newnode, lastnode, edgeindex, &tree->node_count );
-						if( tag && suffix_update != NULL ){
-							suffix_update->suffix_link = newnode;
-						}
-						tag = 1;
-						suffix_update = newnode;
-						if( stree_insert_child( newnode, newleaf, &tree->node_count ) == NULL ) 
-							return 1;
-						lastnode = newnode;
-					}
-					else{
-						if( tag && suffix_update != NULL ){
-							suffix_update -> suffix_link = lastnode;
-							tag = 0;
-						}
-						lastnode = stree_insert_child( lastnode, newleaf, &tree->node_count );
-					}
-				}
-				lastindex = j + 1;
-				lastnode = stree_follow_suffix( lastnode, &edgeindex );
-			}
-		}
-	}
-	//  stree_fix_stringid_suffixlink(tree,tree->strnum);
-	return 0;
-}
-
-char *stree_find_string( SUFFIXTREE *t, unsigned int str_id )
-{
-	RAWSTRING *s;
-	unsigned int i;
-	if( str_id>t->strnum ) 
-		return NULL;
-	for( s = t->raw, i = 0; i < str_id - 1; i++, s = s->next );
-	return s->string;
-}
-
-void stree_print_leaf( NODE *node, SUFFIXTREE *tree )
-{
-	CHILD_STRUCT *c;
-	if( node->node_type != INTERNODE )
-		stree_graph_node( node, tree );
-	else{
-		for( c = node->children; c != NULL; c = c->next ){
-			stree_print_leaf( c->child, tree );
-		}
-	}
-}
-
-void stree_print_suffix( SUFFIXTREE *t )
-{
-	printf( "\n\n\n\t\t\t\t\t|************************************|\n" );
-	printf( "\t\t\t\t\t Printing all the suffix in the tree:\n" );
-	printf( "\t\t\t\t\t|************************************|\n\n\n" );
-	stree_print_leaf( t->root, t );
-}
-
-void stree_print_suffix_withid( SUFFIXTREE *t, unsigned int str_id )
-{
-	char *c = stree_find_string( t, str_id );
-	printf( "\n\nPrinting the suffix of string %d:\n", str_id );
-	stree_print_suffix_node( t->root,str_id, c);
-}
-
-int stree_print_tree( SUFFIXTREE *t )
-{
-	stree_print_subtree( t->root, t );
-	return 0;
-}
-
-int stree_print_subtree( NODE *node, SUFFIXTREE *t )
-{
-	CHILD_STRUCT *c;
-	stree_graph_node( node, t );
-	printf( "the path is  " );
-	stree_print_path( node );
-	printf( "\n" );
-	for( c = node->children; c != NULL; c = c->next ){
-		stree_print_subtree( c->child, t );
-	}
-	return 0;
-}
-
-int stree_graph_node( NODE *node, SUFFIXTREE *tree )
-{
-	STRINGID *t;
-	CHILD_STRUCT *c;
-	unsigned int i;
-	printf( "|" );
-	for( i = 0 ; i < 80; i++ )
-		printf( "*" );
-	printf( "|" );
-	printf( "\nNode # %d:\n", node->node_num );
-	printf( "Node Type: %s\n", node_name[node->node_type] );
-	printf( "String Num: %d\n", node->stringid_num );
-	if( node->start_char != NULL ){
-		printf( "Character(s) on the edge:\t\t " );
-		for( i = 0; i < node->edgelen; i++ )
-			printf( "%c", node->start_char[i] );
-		printf( "\n" );
-	}
-	else{
-		printf( "There are no characters on this edge\n" );
-	}
-	printf( "Edge length is %d\n", node->edgelen );
-	printf( "the depth of character is %d\n", node->char_depth );
-	t = node->strings;
-	while( t != NULL ){
-		if( node->node_type == INTERNODE )
-			printf( "the first appearance is %d in string %d\n", t->str_start, t->str_id );
-		else
-			printf( "The corresponding suffix is\t\t %s\n Starts from index %d in string %d\n",
-			stree_find_string( tree, t->str_id ) + t->str_start, t->str_start, t->str_id );
-		t = t->next;
-	}
-	if( node->node_type == INTERNODE )
-		printf( "The suffix-link points to node %d\n", node->suffix_link->node_num );
-	if( node->node_type == INTERNODE ){
-		printf( "\n" );
-		for( i = 0, c = node->children; c != NULL; c = c->next, i++ ){
-			printf( "\t\tthe %d child is node %d\n", i, c->child->node_num);
-		}
-		printf( "\n" );
-	}
-	printf( "The parent node is %d\n", node->parent->node_num );
-	return 0;
-}  
-
-int stree_print_suffix_node( NODE *node, unsigned int str_id, char *string )
-{
-	CHILD_STRUCT *t;
-	STRINGID *s;
-	if( node->node_type != INTERNODE){
-		for( s = node->strings; s != NULL && s->str_id != str_id; s = s->next );
-		if(s != NULL){
-			printf( "Starting position %4ld:\t%s\n", s->str_start, &string[s->str_start] );
-		}
-	}
-	else{
-		t = node->children;
-		while( t != NULL ){
-			stree_print_suffix_node( t->child, str_id, string );
-			t = t->next;
-		}
-	}
-	return 0;
-}
-
-int stree_add_stringid( STRINGID **p, STRINGID *t, NODE *parent )
-{
-	STRINGID *pa, *a, *b, *NewStr;
-	b = t;
-	if( *p == NULL && b != NULL ){
-		if( ( NewStr = ( STRINGID * )malloc( sizeof( STRINGID ) ) ) == NULL )
-			return 1;
-		NewStr->str_id = b->str_id;
-		NewStr->str_start = b->str_start;
-		NewStr->next = NULL;
-		*p = NewStr;
-		parent->stringid_num++;
-		b = b->next;
-	}
-	pa = NULL;
-	a = *p;
-	while( a != NULL && b != NULL ){
-		if( a->str_id <= b->str_id ){
-			if( a->str_id == b->str_id ){
-				if( a->str_start > b->str_start ){
-					a->str_start = b->str_start;
-				}
-				b = b->next;
-			}
-			pa = a;
-			a = a->next;
-		}
-		else{
-			if( ( NewStr = ( STRINGID * )malloc( sizeof( STRINGID ) ) ) == NULL )
-				return 1;
-			NewStr->str_id = b->str_id;
-			NewStr->str_start = b->str_start;
-			if( pa == NULL ){
-				( *p ) = NewStr;
-			}
-			else{
-				pa->next = NewStr;
-			}
-			parent->stringid_num++;
-			pa = NewStr;
-			NewStr->next = a;
-			b = b->next;
-		}
-	}
-	while( b != NULL ){
-		if( ( NewStr = ( STRINGID* )malloc( sizeof( STRINGID ) ) ) == NULL )
-			return 1;
-		NewStr->str_id = b->str_id;
-		NewStr->str_start = b->str_start;
-		NewStr->next = NULL;
-		parent->stringid_num++;
-		pa->next = NewStr;
-		pa = NewStr;
-		b = b->next;
-	}
-	return 0;
-}
-
-NODE * stree_next_suffix( NODE *node, unsigned int str_id )
-{
-	NODE *parent, *t;
-	if( node->node_type == INTERNODE ){
-		t = node->suffix_link;
-	}
-	else{
-		parent = node->parent;
-		if( node->node_type == INTERLEAF ){
-			t = parent->suffix_link;
-		}
-		else{
-			if( parent->char_depth != parent->suffix_link->char_depth ){
-				t = stree_walk_down( parent->suffix_link, node->start_char,	node->edgelen,str_id );
-			}
-			else{
-				if( node->edgelen > 1 ){
-					t = stree_walk_down( parent->suffix_link, node->start_char + 1, node->edgelen - 1, str_id );
-				}
-				else{
-					return parent->suffix_link;
-				}
-			}
-		}
-	}
-	if( t->node_type == INTERNODE && t->node_num != 1 )
-		t = t->children->child;
-	assert( t );
-	return t;  
-}
-
-int stree_test( SUFFIXTREE *tree )
-{
-	NODE *t;
-	char *c;
-	c = stree_find_string( tree, 2 );
-	t = stree_walk_down( tree->root, c, strlen( c ), 2 );
-	while( t != tree->root ){
-		printf( "Node #:\t %d\n", t->node_num );
-		t = stree_next_suffix( t, 2 );
-	}
-	return 0;
-}
-
-int stree_query_string( SUFFIXTREE *t, char *string )
-{
-	NODE *start;
-	if( ( start = stree_walk_down( t->root, string, strlen( string ), 0 ) ) == NULL )
-		return 1;
-	stree_print_leaf( start, t );
-	return 0;
-}
-
-void stree_fill_leaf( NODE *node, int *s )
-{
-}
-
-int stree_fill_pattern( SUFFIXTREE *p, char *string, int *s, int size)
-{
-	NODE *start;
-	if( ( start = stree_walk_and_fill( p->root, string, strlen( string ), s, size ) ) == NULL )
-		return 1;
-	stree_fill_leaf( start, s );
-	return 0;
-}
-
-int stree_report_occurence( SUFFIXTREE *p, char *string, int *s, int size, int nid )
-{
-	NODE *start;
-	if( ( start = stree_walk_and_report( p->root, string, strlen( string ), s, size,nid ) ) == NULL )
-		return 1;
-	stree_print_leaf( start, p );
-	return 0;
-}
-
-int stree_print_path( NODE *t )
-{
-	NODE *p = t;
-	char *ch;
-	int i;
-
-	if ( p->parent != p ){
-		stree_print_path( p->parent );
-		for( i = 0, ch = t->start_char; i < p->edgelen; i++, ch++ )
-			printf( "%c", *ch );
-	}
-	return 0;
-}
-
-int whichclass( int a, int *b )
-{
-	int i;
-	for( i = 0; a > b[i]; a -= b[i++] );
-	return i;
-}
-
-int stree_sigstring_report(NODE *t,int *idclass)
-{
-	int i, count[CLASSMAX] = {0}, max_index, secmax_index;
-	double max, secmax;
-	STRINGID *p;
-	CHILD_STRUCT * child;
-	for( i = 0 , p = t->strings; p != NULL && i < t->stringid_num - 1; p = p->next, i++ ){
-		count[whichclass( ( p->str_id ), idclass )]++;
-	}
-	max = ( double )count[0] / ( double )idclass[0];
-	max_index = 0;
-	secmax = -1;
-	for( i = 1 ;i<CLASSMAX; i++ ){
-		if( ( double ) count[i] / ( double )idclass[i] > max ){
-			secmax = max;
-			secmax_index = max_index;
-			max = ( double )count[i] / ( double )idclass[i];
-			max_index = i;
-		}
-		else{
-			if( ( double ) count[i] / ( double )idclass[i] > secmax){
-				secmax = ( double ) count[i] / ( double )idclass[i];
-				secmax_index = i;
-			}
-		}
-	}
-	if (/*max>=HIGHLEVL&&secmax<=LOWLEVL&&*/max * ( double ) idclass[max_index] >= 75 ){
-		printf( "\nThe signature substring for class %d is ", max_index + 1 );
-		stree_print_path( t );
-		printf(" with %.0f instances.\n", max*(double)idclass[max_index]);
-	}
-
-	for( child = t->children; child != NULL; child = child->next ){
-		if( child->child->node_type == INTERNODE ||
-			( child->child->node_type == LEAF && child->child->edgelen != 0 ) ){
-				stree_sigstring_report( child->child, idclass );
-		}
-	}
-	return 0;
-}
-
-int check_stringid_integrity( NODE *t )
-{
-	int i = 0;
-	STRINGID *p;
-	p = t->strings;
-	while(p != NULL ){
-		i++;
-		p = p->next;
-	}
-	return i == t->stringid_num ? 1 : 0;
-}
-
-int stree_fix_subtree_id( NODE *t, int *idclass )
-{
-	int i, count[CLASSMAX] = {0}, max_index, secmax_index, ptag;
-	double max, secmax;
-	STRINGID *p;
-	CHILD_STRUCT * child;
-	ptag = 0;
-
-	for( child = t->children; child != NULL; child = child->next ){
-		if( child->child->node_type == INTERNODE ){
-			ptag += stree_fix_subtree_id( child->child, idclass );
-		}
-		stree_add_stringid( &t->strings, child->child->strings, t );
-		if( !check_stringid_integrity ( t ) ){
-			printf( "Stringid number incorrect in node %d!\n", t->node_num );
-		}
-	}
-	if( ptag == 0 ){
-		for( i = 0, p = t->strings; p != NULL && i < t->stringid_num; p = p->next, i++){
-			count[whichclass( ( p->str_id ), idclass )]++;
-		}
-
-		max = ( double )count[0] / ( double )idclass[0];
-		max_index = 0;
-		secmax = -1;
-
-		for( i = 1; i < CLASSMAX; i++ ){
-			if( ( double )count[i] / ( double )idclass[i] > max ){
-				secmax = max;
-				secmax_index = max_index;
-				max = ( double )count[i] / ( double )idclass[i];
-				max_index = i;
-			}
-			else{
-				if( ( double )count[i] / ( double )idclass[i] > secmax){
-					secmax = ( double )count[i] / ( double )idclass[i];
-					secmax_index = i;
-				}
-			}
-		}
-		if (/*max>=HIGHLEVL&&secmax<=LOWLEVL&&*/ max * ( double ) idclass[max_index] >= 500 ){
-
-			printf( "\n%d\t", max_index + 1 );
-			stree_print_path( t );
-			printf( "\t%.0f\t %.2f\t %.2f\n", max * ( double )idclass[max_index], max, secmax );
-			ptag = 1;  
-		}										
-	}
-	return ptag;
-}
-
-/*add all the string ids to its parent, including all the occurences of the same substring
-
-*/
-int add_stringid( STRINGID **p, STRINGID *t, NODE *parent )
-{
-	STRINGID *pa, *a, *b, *NewStr;
-	b = t;
-	if( *p == NULL && b != NULL ){
-		if( ( NewStr = ( STRINGID * )malloc( sizeof( STRINGID ) ) ) == NULL )
-			return 1;
-		NewStr->str_id = b->str_id;
-		NewStr->str_start = b->str_start;
-		NewStr->next = NULL;
-		*p = NewStr;
-		//parent->stringid_num++;
-		b = b->next;
-	}
-	pa = NULL;
-	a = *p;
-	while( a != NULL && b != NULL ){
-		if( a->str_id < b->str_id ){
-			pa = a;
-			a = a->next;
-		}
-		else if( a->str_id == b->str_id ){
-			if( ( NewStr = ( STRINGID * )malloc( sizeof( STRINGID ) ) ) == NULL )
-				return 1;
-			NewStr->str_id = b->str_id;
-			NewStr->str_start = b->str_start;
-			if( a->str_start < b->str_start ) {
-				NewStr->next = a->next;
-				a->next = NewStr;
-				pa = a;
-				a = NewStr;
-			}
-			else{
-				if( pa == NULL ){
-					( *p ) = NewStr;
-				}
-				else{
-					pa->next = NewStr;
-				}
-				pa = NewStr;
-				NewStr->next = a;
-			}
-			b = b->next;
-		}
-		else{
-			if( ( NewStr = ( STRINGID * )malloc( sizeof( STRINGID ) ) ) == NULL )
-				return 1;
-			NewStr->str_id = b->str_id;
-			NewStr->str_start = b->str_start;
-			if( pa == NULL ){
-				( *p ) = NewStr;
-			}
-			else{
-				pa->next = NewStr;
-			}
-			//parent->stringid_num++;
-			pa = NewStr;
-			NewStr->next = a;
-			b = b->next;
-		}
-	}
-	while( b != NULL ){
-		if( ( NewStr = ( STRINGID* )malloc( sizeof( STRINGID ) ) ) == NULL )
-			return 1;
-		NewStr->str_id = b->str_id;
-		NewStr->str_start = b->str_start;
-		NewStr->next = NULL;
-		//parent->stringid_num++;
-		pa->next = NewStr;
-		pa = NewStr;
-		b = b->next;
-	}
-	return 0;
-}
-
-int get_stringid_num( NODE* t )
-{
-	int num = 0;
-	STRINGID *p, *pre;
-	p = t->strings;
-	while( p != NULL ){
-		pre = p;
-		p = p->next;
-		if( p == NULL)
-			num++;
-		else if( pre->str_id != p->str_id )
-			num++;
-	}
-
-	return num ;
-}
-
-int get_embedding_num( NODE* t )
-{
-	int num = 0;
-	STRINGID *p;
-	p = t->strings;
-	if( p == NULL )
-		return 0;
-	num = 1;
-	while( p->next != NULL ){
-		num++;
-		p = p->next;
-	}
-	return num ;
-}
-
-// fix the string id of each node of the tree when multiple occurences of substring are taken into consideration.
-int fix_stringid( NODE *t )
-{
-	int i;
-	STRINGID *p;
-	CHILD_STRUCT * child;
-
-	for( child = t->children; child != NULL; child = child->next ){
-		if( child->child->node_type == INTERNODE ){
-			 fix_stringid( child->child );
-		}
-		// bottom-up method, add the children's ids to the parent'.
-		add_stringid( &t->strings, child->child->strings, t );
-		t->stringid_num =  get_stringid_num( t );
-		t->embedding_num = get_embedding_num( t );
-	}
-	return 0;
-}
-// travse the tree to find substring given a threshold sup
-int find_substring(  int min_sup, NODE *node, NODE *output[], int *output_size )
-{
-	CHILD_STRUCT *c;
-
-	if( node->stringid_num >= min_sup && node->char_depth != 0 ){
-		output[*output_size] = node;
-		(*output_size)++;
-	}
-	for( c = node->children; c != NULL; c = c->next ){
-		find_substring( min_sup, c->child, output, output_size );
-	}
-	return 0;
-}
-
-string get_substring( NODE *s )
-{
-	NODE *p = s;
-	string str ;
-	if( p->parent != p ){
-		str = get_substring( p->parent );
-		string t = string( p->start_char, p->start_char + p->edgelen );
-		str +=  t;
-		return str;
-	}
-	str = "";
-	return str;
-}	
-
-int get_closed_string( NODE *input[], int input_size, NODE *output[], int* output_size )
-{
-	list<NODE*> node_list;
-	for( int i = 0; i < input_size; i ++ ){
-		node_list.push_front( input[i] );
-	}
-	
-	bool is_delete; 
-	list<NODE*>::iterator it1, it2, end;
-	string str1, str2;
-	it1 = node_list.begin();
-	end =  node_list.end();
-
-	while( it1 != end ){
-		is_delete = false;
-		it2 = it1;
-		++it2;
-		while( it2 != end ){
-			if( (*it1)->char_depth > (*it2)->char_depth ){ 
-				str1 = get_substring( *it1 );
-				str2 = get_substring( *it2 );
-				char *ptr= strstr( const_cast<char*>(str1.c_str()) , str2.c_str() );
-				if( ptr != NULL ){
-					if( (*it1)->stringid_num == (*it2)->stringid_num ){
-						NODE* t = *(it2);
-						++it2;
-						node_list.remove( t );
-						continue;
-					}
-				}
-			}
-			else if( (*it1)->char_depth < (*it2)->char_depth ){
-				str1 = get_substring( *it1 );
-				str2 = get_substring( *it2 );
-				char *ptr= strstr( const_cast<char*>(str2.c_str()) , str1.c_str() );
-				if( ptr != NULL ){
-					if( (*it1)->stringid_num == (*it2)->stringid_num ){
-						is_delete = true;
-						NODE* t = *(it1);
-						++it1;
-						node_list.remove( t );
-						break;
-					}
-				}
-			}
-			++it2;
-		}
-		if( is_delete == true )
-			continue;
-		++it1;
-	}
-
-	*output_size = 0;
-	for( it1 = node_list.begin(); it1 != node_list.end(); it1++ )
-	{
-		output[ (*output_size)++ ] = *it1;
-	}
-
-	return 0;
-}
-
-int get_closed_string( NODE *input[], int input_size, list<NODE*> &node_list )
-{
-	for( int i = 0; i < input_size; i ++ ){
-		node_list.push_front( input[i] );
-	}
-	
-	bool is_delete; 
-	list<NODE*>::iterator it1, it2, end;
-	string str1, str2;
-	it1 = node_list.begin();
-	end =  node_list.end();
-
-	while( it1 != end ){
-		is_delete = false;
-		it2 = it1;
-		++it2;
-		while( it2 != end ){
-			if( (*it1)->char_depth > (*it2)->char_depth ){ 
-				str1 = get_substring( *it1 );
-				str2 = get_substring( *it2 );
-				char *ptr= strstr( const_cast<char*>(str1.c_str()) , str2.c_str() );
-				if( ptr != NULL ){
-					if( (*it1)->stringid_num == (*it2)->stringid_num ){
-						NODE* t = *(it2);
-						++it2;
-						node_list.remove( t );
-						continue;
-					}
-				}
-			}
-			else if( (*it1)->char_depth < (*it2)->char_depth ){
-				str1 = get_substring( *it1 );
-				str2 = get_substring( *it2 );
-				char *ptr= strstr( const_cast<char*>(str2.c_str()) , str1.c_str() );
-				if( ptr != NULL ){
-					if( (*it1)->stringid_num == (*it2)->stringid_num ){
-						is_delete = true;
-						NODE* t = *(it1);
-						++it1;
-						node_list.remove( t );
-						break;
-					}
-				}
-			}
-			++it2;
-		}
-		if( is_delete == true )
-			continue;
-		++it1;
-	}
-
-	return 0;
-}
-
-/*
-int get_closed_string( int sup, NODE *tar[], int num, NODE *init_can[], int* count )
-{
-	int i, j, flag;
-	NODE *p, *q;
-	STRINGID *pstr, *qstr, *pre;; 
-	for( i = 0; i < num; i++ ){
-		for( j = i+1; j < num; j++){
-			if( tar[i]->char_depth <= tar[j]->char_depth ){
-				p = tar[i];
-				q = tar[j];
-			}
-			else{
-				p = tar[j];
-				q = tar[i];
-			}
-			
-			pre = NULL;
-			pstr = p->strings;	
-			while( pstr != NULL ){
-				qstr = q->strings;
-				flag = 0;
-				while( qstr != NULL){
-					if( pstr->str_id < qstr->str_id )
-						break;
-					else if( pstr->str_id > qstr->str_id )
-						qstr = qstr->next;
-					else{
-						if( (pstr->str_start >= qstr->str_start) && ( pstr->str_start+p->char_depth <= qstr->str_start+q->char_depth ) ){
-							if( pre == NULL ){
-								pre = pstr;
-								p->strings = pstr->next;
-								pstr = p->strings;
-								free( pre );
-								pre = NULL;	
-							}
-							else{
-								pre->next = pstr->next;
-								free( pstr );
-								pstr = pre->next;
-							}
-							flag = 1;
-							break;
-						}
-						qstr = qstr->next;
-					}
-				}
-				if( flag != 1 ){
-					pre = pstr;
-					pstr = pstr->next;
-				}
-			}
-		}
-		if( get_stringid_num( tar[i] ) >= sup )
-			init_can[(*count)++] = tar[i];
-	}
-	return 0;
-}
-*/
-
-
-int stree_print_path_file( NODE *t, FILE *fp )
-{
-	NODE *p = t;
-	char *ch;
-	int i;
-
-	if ( p->parent != p ){
-		stree_print_path_file( p->parent, fp );
-		for( i = 0, ch = t->start_char; i < p->edgelen; i++, ch++ )
-			fprintf( fp, "%c", *ch );
-	}
-	return 0;
-}
-
-
-
-
+#include "suffix_tree.h"
+#include "stree_walk.h"
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const char * const node_name[3] = { "Internode", "Interleaf", "Leaf" };
+
+#define STREE_CHUNK_BYTES  ( 1 << 20 )
+#define STREE_POSTING_CHUNK_BYTES  ( 1 << 16 )
+
+/* Prepare an arena. Only the item sizes are set, no chunk is
+* allocated until the first request.
+* Parameter:  arena: the arena of a tree
+* Last modified:  10/18/2026
+*/
+
+void stree_arena_init( STREE_ARENA *arena )
+{
+	int k;
+	memset( ( void * )arena, 0, sizeof( STREE_ARENA ) );
+	arena->nodes.item_size = sizeof( NODE );
+	arena->children.item_size = sizeof( CHILD_STRUCT );
+	for( k = 0; k < POSTING_CLASSES; k++ ){
+		/* most lists stay small, so their chunks are kept small too */
+		arena->posting[k].item_size = ( size_t )16 << k;
+		arena->posting[k].chunk_size = STREE_POSTING_CHUNK_BYTES;
+	}
+	arena->index[CHILD_SMALL].item_size = sizeof( CHILD_INDEX ) + CHILD_SMALL_MAX * ( 1 + sizeof( CHILD_STRUCT * ) );
+	arena->index[CHILD_SORTED].item_size = sizeof( CHILD_INDEX ) + CHILD_SORTED_MAX * ( 1 + sizeof( CHILD_STRUCT * ) );
+	arena->index[CHILD_DIRECT].item_size = sizeof( CHILD_INDEX ) + 256 * sizeof( CHILD_STRUCT * );
+}
+
+/* Make a chunk of at least len usable bytes the current chunk
+* of the pool, reusing a spare one when it is large enough
+* Parameter:  pool: the pool
+*             len:  the minimum number of bytes needed
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_pool_grow( STREE_POOL *pool, size_t len )
+{
+	STREE_CHUNK *c;
+	size_t size;
+
+	size = pool->chunk_size != 0 ? pool->chunk_size : STREE_CHUNK_BYTES;
+	if( size < len )
+		size = len;
+	if( pool->spare != NULL && pool->spare->size >= size ){
+		c = pool->spare;
+		pool->spare = c->next;
+	}
+	else if( ( c = ( STREE_CHUNK * )malloc( sizeof( STREE_CHUNK ) + size ) ) != NULL ){
+		c->size = size;
+	}
+	else{
+		printf( "Error: chunk allocation fail!" );
+		return 1;
+	}
+	c->next = pool->chunks;
+	pool->chunks = c;
+	pool->chunk_count++;
+	pool->next_item = ( char * )( c + 1 );
+	pool->end = pool->next_item + c->size;
+	return 0;
+}
+
+/* Take one item from a fixed-size pool
+* Parameter:  pool: the pool
+* Return:     pointer to the item, NULL if fails
+* Last modified:  10/18/2026
+*/
+
+void *stree_pool_alloc( STREE_POOL *pool )
+{
+	void *item;
+
+	if( ( item = pool->free_list ) != NULL ){
+		pool->free_list = *( void ** )item;
+		return item;
+	}
+	if( pool->next_item == NULL || pool->next_item + pool->item_size > pool->end ){
+		if( stree_pool_grow( pool, pool->item_size ) )
+			return NULL;
+	}
+	item = pool->next_item;
+	pool->next_item += pool->item_size;
+	return item;
+}
+
+/* Give an item back to its pool. The memory stays in the
+* pool and is handed out again by stree_pool_alloc.
+* Parameter:  pool: the pool the item was taken from
+*             item: the item
+* Last modified:  10/18/2026
+*/
+
+void stree_pool_free( STREE_POOL *pool, void *item )
+{
+	if( item == NULL )
+		return;
+	*( void ** )item = pool->free_list;
+	pool->free_list = item;
+}
+
+/* Move all the chunks of a pool to its spare list
+* Last modified:  10/18/2026
+*/
+
+void stree_pool_recycle( STREE_POOL *pool )
+{
+	STREE_CHUNK *c;
+	while( ( c = pool->chunks ) != NULL ){
+		pool->chunks = c->next;
+		c->next = pool->spare;
+		pool->spare = c;
+	}
+	pool->next_item = pool->end = NULL;
+	pool->free_list = NULL;
+	pool->chunk_count = 0;
+}
+
+/* Release all the chunks of a pool
+* Last modified:  10/18/2026
+*/
+
+void stree_pool_release( STREE_POOL *pool )
+{
+	STREE_CHUNK *c;
+	stree_pool_recycle( pool );
+	while( ( c = pool->spare ) != NULL ){
+		pool->spare = c->next;
+		free( c );
+	}
+}
+
+/* Move all the chunks and free items of one pool into another
+* pool of the same item size. The items of from stay where they
+* are and belong to pool afterwards; from is left empty.
+* Parameter:  pool: the pool that takes the chunks
+*             from: the pool that gives them up
+* Last modified:  10/18/2026
+*/
+
+void stree_pool_adopt( STREE_POOL *pool, STREE_POOL *from )
+{
+	STREE_CHUNK *c;
+	void **item;
+
+	if( from->chunks != NULL ){
+		if( pool->chunks == NULL ){
+			pool->chunks = from->chunks;
+			pool->next_item = from->next_item;
+			pool->end = from->end;
+		}
+		else{
+			/* the current chunk of pool stays in front, so the chunk of
+			from that was being filled is cut down to its used part */
+			from->chunks->size = from->next_item - ( char * )( from->chunks + 1 );
+			for( c = from->chunks; c->next != NULL; c = c->next );
+			c->next = pool->chunks->next;
+			pool->chunks->next = from->chunks;
+		}
+		pool->chunk_count += from->chunk_count;
+	}
+	if( from->free_list != NULL ){
+		for( item = ( void ** )from->free_list; *item != NULL; item = ( void ** )*item );
+		*item = pool->free_list;
+		pool->free_list = from->free_list;
+	}
+	if( from->spare != NULL ){
+		for( c = from->spare; c->next != NULL; c = c->next );
+		c->next = pool->spare;
+		pool->spare = from->spare;
+	}
+	from->chunks = from->spare = NULL;
+	from->next_item = from->end = NULL;
+	from->free_list = NULL;
+	from->chunk_count = 0;
+}
+
+size_t stree_pool_usage( STREE_POOL *pool )
+{
+	STREE_CHUNK *c;
+	size_t total = 0;
+	for( c = pool->chunks; c != NULL; c = c->next )
+		total += sizeof( STREE_CHUNK ) + c->size;
+	for( c = pool->spare; c != NULL; c = c->next )
+		total += sizeof( STREE_CHUNK ) + c->size;
+	return total;
+}
+
+/* Initialize an empty tree. A zero-filled SUFFIXTREE is
+* also a valid empty tree.
+* Parameter:  tree: the SUFFIXTREE
+* Last modified:  10/18/2026
+*/
+
+void stree_init( SUFFIXTREE *tree )
+{
+	memset( ( void * )tree, 0, sizeof( SUFFIXTREE ) );
+	stree_arena_init( &tree->arena );
+}
+
+/* Empty the tree but keep its chunks and text buffer for the
+* next strings. All the nodes of the tree become invalid.
+* Parameter:  tree: the SUFFIXTREE
+* Last modified:  10/18/2026
+*/
+
+void stree_reset( SUFFIXTREE *tree )
+{
+	int k;
+	stree_pool_recycle( &tree->arena.nodes );
+	stree_pool_recycle( &tree->arena.children );
+	for( k = 0; k < POSTING_CLASSES; k++ )
+		stree_pool_recycle( &tree->arena.posting[k] );
+	stree_pool_recycle( &tree->arena.index[CHILD_SMALL] );
+	stree_pool_recycle( &tree->arena.index[CHILD_SORTED] );
+	stree_pool_recycle( &tree->arena.index[CHILD_DIRECT] );
+	tree->strnum = 0;
+	tree->str_evicted = 0;
+	tree->str_base = 0;
+	tree->text_len = 0;
+	tree->root = NULL;
+	tree->node_count = 0;
+}
+
+/* Free the whole tree in O(number of chunks). The tree
+* is left empty and can be reused.
+* Parameter:  tree: the SUFFIXTREE
+* Last modified:  10/18/2026
+*/
+
+void stree_destroy( SUFFIXTREE *tree )
+{
+	int k;
+	stree_pool_release( &tree->arena.nodes );
+	stree_pool_release( &tree->arena.children );
+	for( k = 0; k < POSTING_CLASSES; k++ )
+		stree_pool_release( &tree->arena.posting[k] );
+	free( tree->text );
+	free( tree->str_offset );
+	stree_pool_release( &tree->arena.index[CHILD_SMALL] );
+	stree_pool_release( &tree->arena.index[CHILD_SORTED] );
+	stree_pool_release( &tree->arena.index[CHILD_DIRECT] );
+	stree_init( tree );
+}
+
+/* Return the number of bytes held by the tree
+* Last modified:  10/18/2026
+*/
+
+size_t stree_memory_usage( SUFFIXTREE *tree )
+{
+	size_t total;
+	int k;
+	total = stree_pool_usage( &tree->arena.nodes ) + stree_pool_usage( &tree->arena.children )
+		+ tree->text_size + sizeof( unsigned int ) * tree->offset_size
+		+ stree_pool_usage( &tree->arena.index[CHILD_SMALL] ) + stree_pool_usage( &tree->arena.index[CHILD_SORTED] )
+		+ stree_pool_usage( &tree->arena.index[CHILD_DIRECT] );
+	for( k = 0; k < POSTING_CLASSES; k++ )
+		total += stree_pool_usage( &tree->arena.posting[k] );
+	return total;
+}
+
+/* Allocate a new node 
+* Parameter:  arena: the arena of the tree
+*             type:  INTERNODE | INTERLEAF | LEAF
+* Return:     the pointer to the new node
+*             NULL if fails
+* Last modified:  10/18/2026
+*/
+
+NODE *stree_alloc_node( STREE_ARENA *arena, int type )
+{
+	NODE *NewNode;
+
+	if( ( NewNode = ( NODE * ) stree_pool_alloc( &arena->nodes ) ) != NULL ){
+		memset( ( void * )NewNode, 0, sizeof( NODE ) );
+		NewNode->node_type = type;
+		NewNode->stringid_num = 0;
+		NewNode->embedding_num = 0;
+	}
+	else{
+		printf( "Error: node allocation fail!" );
+	}
+	return NewNode;
+}
+
+/* Create a new CHILD_STRUCT
+* Parameter:  arena: the arena of the tree
+*             child: the corresponding child NODE
+*             next:  the next CHILD_STRUCT
+* Return:     pointer to the created CHILD_STRUCT
+*             NULL if fails
+* Last modified:  10/18/2026
+*/  
+
+CHILD_STRUCT *stree_new_child_struct( STREE_ARENA *arena, NODE *child, CHILD_STRUCT *next )
+{
+	CHILD_STRUCT *NewChild;
+
+	if( ( NewChild = ( CHILD_STRUCT * )stree_pool_alloc( &arena->children ) )!= NULL ){
+		NewChild->child = child;
+		NewChild->next = next;
+	}
+	else{
+		printf( "Error: child struct allocation fail!" );
+	}
+	return NewChild;
+}
+
+/* Write v as a varint, 7 bits a byte, low bits first
+* Return:     the number of bytes written
+*/
+
+static unsigned int stree_varint_put( unsigned char *p, unsigned int v )
+{
+	unsigned int n = 0;
+	while( v >= 0x80 ){
+		p[n++] = ( unsigned char )( v | 0x80 );
+		v >>= 7;
+	}
+	p[n++] = ( unsigned char )v;
+	return n;
+}
+
+/* Write v as a varint of exactly width bytes, which is at least
+* the length of its shortest form; the bytes past it are 0x80 */
+static void stree_varint_pad( unsigned char *p, unsigned int v, unsigned int width )
+{
+	unsigned int n;
+	for( n = 0; n + 1 < width; n++ ){
+		p[n] = ( unsigned char )( v | 0x80 );
+		v >>= 7;
+	}
+	p[n] = ( unsigned char )v;
+}
+
+/* Read a varint. The shift is masked for the padding bytes
+* of stree_varint_pad, which hold no bits */
+static unsigned int stree_varint_get( unsigned char *p, unsigned int *pos )
+{
+	unsigned int v, shift;
+	unsigned char b;
+	for( v = 0, shift = 0; ( b = p[( *pos )++] ) & 0x80; shift += 7 )
+		v |= ( unsigned int )( b & 0x7F ) << ( shift & 31 );
+	return v | ( unsigned int )b << ( shift & 31 );
+}
+
+/* the size class of the buffer holding len bytes */
+static unsigned int stree_posting_class( unsigned int len )
+{
+	unsigned int k;
+	for( k = 0; ( 16u << k ) < len; k++ );
+	return k;
+}
+
+/* Append a STRINGID to a posting list. It must not sort before
+* the last one in the list.
+* Parameter:  arena:     the arena of the tree
+*             list:      the posting list
+*             str_id:    the ID of the string
+*             str_start: the starting index in the string
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_posting_append( STREE_ARENA *arena, POSTING *list, unsigned int str_id, unsigned int str_start )
+{
+	unsigned char code[10], *data;
+	unsigned int n, len;
+
+	if( list->count != 0 && str_id == list->last_id ){
+		n = stree_varint_put( code, 0 );
+		n += stree_varint_put( code + n, str_start - list->last_start );
+	}
+	else{
+		n = stree_varint_put( code, str_id - list->last_id );
+		n += stree_varint_put( code + n, str_start );
+	}
+	len = list->len + n;
+	if( len > POSTING_INLINE && ( list->len <= POSTING_INLINE || len > ( 16u << stree_posting_class( list->len ) ) ) ){
+		/* move to a buffer of the next size class */
+		if( ( data = ( unsigned char * )stree_pool_alloc( &arena->posting[stree_posting_class( len )] ) ) == NULL ){
+			printf( "Error: posting list allocation fail!" );
+			return 1;
+		}
+		memcpy( data, POSTING_DATA( list ), list->len );
+		if( list->len > POSTING_INLINE )
+			stree_pool_free( &arena->posting[stree_posting_class( list->len )], list->data );
+		list->data = data;
+	}
+	memcpy( ( len <= POSTING_INLINE ? list->bytes : list->data ) + list->len, code, n );
+	list->len = len;
+	list->count++;
+	list->last_id = str_id;
+	list->last_start = str_start;
+	return 0;
+}
+
+/* Decode the next STRINGID of a posting list
+* Parameter:  list: the posting list
+*             pos:  the byte position, 0 for the first STRINGID
+*             s:    the previous STRINGID, replaced by the next
+* Return:     1 if a STRINGID was decoded, 0 at the end of the list
+* Last modified: 10/18/2026
+*/
+
+int stree_posting_next( POSTING *list, unsigned int *pos, STRINGID *s )
+{
+	unsigned char *data;
+	unsigned int d, x;
+	int first;
+
+	if( *pos >= list->len )
+		return 0;
+	data = POSTING_DATA( list );
+	first = *pos == 0;
+	d = stree_varint_get( data, pos );
+	x = stree_varint_get( data, pos );
+	if( d == 0 && !first )
+		s->str_start += x;
+	else{
+		s->str_id = first ? d : s->str_id + d;
+		s->str_start = x;
+	}
+	return 1;
+}
+
+/* Check if a string ID is in a posting list. The largest ID,
+* the one checked during the construction, is found in O(1).
+* Return:     1 if found, 0 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_posting_find( POSTING *list, unsigned int str_id )
+{
+	STRINGID s;
+	unsigned int pos;
+
+	if( list->count == 0 || str_id > list->last_id )
+		return 0;
+	if( str_id == list->last_id )
+		return 1;
+	for( pos = 0; stree_posting_next( list, &pos, &s ) && s.str_id <= str_id; ){
+		if( s.str_id == str_id )
+			return 1;
+	}
+	return 0;
+}
+
+/* Position in a posting list during a merge */
+typedef struct posting_cursor{
+	STRINGID s;
+	unsigned int pos;
+	POSTING *list;
+}POSTING_CURSOR;
+
+static bool posting_cursor_greater( const POSTING_CURSOR &a, const POSTING_CURSOR &b )
+{
+	return a.s.str_id != b.s.str_id ? a.s.str_id > b.s.str_id : a.s.str_start > b.s.str_start;
+}
+
+/* Merge sorted posting lists into a new one in a single pass
+* Parameter:  arena:    the arena of the tree
+*             out:      the merged list (for return), built from
+*                       empty, may not be one of lists
+*             lists:    the lists to merge
+*             num:      the number of lists
+*             distinct: 1 to keep one STRINGID for each string ID,
+*                       the one with the smallest str_start
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_posting_union( STREE_ARENA *arena, POSTING *out, POSTING **lists, unsigned int num, int distinct )
+{
+	vector< POSTING_CURSOR > heap;
+	POSTING_CURSOR c;
+	unsigned int i;
+
+	memset( ( void * )out, 0, sizeof( POSTING ) );
+	for( i = 0; i < num; i++ ){
+		c.list = lists[i];
+		c.pos = 0;
+		if( stree_posting_next( c.list, &c.pos, &c.s ) )
+			heap.push_back( c );
+	}
+	make_heap( heap.begin(), heap.end(), posting_cursor_greater );
+	while( !heap.empty() ){
+		pop_heap( heap.begin(), heap.end(), posting_cursor_greater );
+		c = heap.back();
+		if( !distinct || out->count == 0 || c.s.str_id != out->last_id ){
+			if( stree_posting_append( arena, out, c.s.str_id, c.s.str_start ) ){
+				stree_posting_free( arena, out );
+				return 1;
+			}
+		}
+		if( stree_posting_next( c.list, &c.pos, &heap.back().s ) ){
+			heap.back().pos = c.pos;
+			push_heap( heap.begin(), heap.end(), posting_cursor_greater );
+		}
+		else
+			heap.pop_back();
+	}
+	return 0;
+}
+
+/* Remove the first STRINGID of a posting list in O(1). The next
+* one is written in full over both, padded to their length, so the
+* bytes after them stay in place. The list is coded again when the
+* padding grows to half of it.
+* Parameter:  arena: the arena of the tree
+*             list:  the posting list, not empty
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_posting_pop( STREE_ARENA *arena, POSTING *list )
+{
+	unsigned char code[10], *data;
+	unsigned int pos, n, pad;
+	STRINGID s;
+
+	if( list->count <= 1 ){
+		stree_posting_free( arena, list );
+		return 0;
+	}
+	data = POSTING_DATA( list );
+	pos = 0;
+	stree_posting_next( list, &pos, &s );
+	stree_posting_next( list, &pos, &s );
+	n = stree_varint_put( code, s.str_start );
+	pad = pos - n - stree_varint_put( code + n, s.str_id );
+	stree_varint_pad( data, s.str_id, pos - n );
+	memcpy( data + pos - n, code, n );
+	list->count--;
+	if( 2 * pad > list->len )
+		return stree_posting_shift( arena, list, 0 );
+	return 0;
+}
+
+/* Subtract delta from the string IDs of a posting list in O(1):
+* only the first ID is stored in full, and its smaller value is
+* written in place, padded to the same length.
+* Parameter:  list:  the posting list, whose IDs are all over delta
+*             delta: the number to subtract
+* Last modified: 10/18/2026
+*/
+
+void stree_posting_lower( POSTING *list, unsigned int delta )
+{
+	unsigned char code[10], *data;
+	unsigned int pos, n;
+	STRINGID s;
+
+	if( list->count == 0 )
+		return;
+	data = POSTING_DATA( list );
+	pos = 0;
+	stree_posting_next( list, &pos, &s );
+	n = stree_varint_put( code, s.str_start );
+	stree_varint_pad( data, s.str_id - delta, pos - n );
+	list->last_id -= delta;
+}
+
+/* Add delta to every string ID of a posting list. Only the
+* first ID is stored in full, so the list is coded again.
+* Return:     0 if successful, 1 otherwise
+* Last modified:  10/18/2026
+*/
+
+int stree_posting_shift( STREE_ARENA *arena, POSTING *list, int delta )
+{
+	POSTING shifted;
+	STRINGID s;
+	unsigned int pos;
+
+	if( list->count == 0 )
+		return 0;
+	memset( ( void * )&shifted, 0, sizeof( POSTING ) );
+	for( pos = 0; stree_posting_next( list, &pos, &s ); ){
+		if( stree_posting_append( arena, &shifted, s.str_id + delta, s.str_start ) ){
+			stree_posting_free( arena, &shifted );
+			return 1;
+		}
+	}
+	stree_posting_free( arena, list );
+	*list = shifted;
+	return 0;
+}
+
+/* Give the buffer of a posting list back to the arena and
+* empty the list
+* Last modified: 10/18/2026
+*/
+
+void stree_posting_free( STREE_ARENA *arena, POSTING *list )
+{
+	if( list->len > POSTING_INLINE )
+		stree_pool_free( &arena->posting[stree_posting_class( list->len )], list->data );
+	memset( ( void * )list, 0, sizeof( POSTING ) );
+}
+
+/* Return a node and its string IDs to the arena
+* Parameter:  arena: the arena of the tree
+*             node:  the node, which must not be linked
+*                    into the tree
+* Last modified:  10/18/2026
+*/
+
+void stree_free_node( STREE_ARENA *arena, NODE *node )
+{
+	stree_posting_free( arena, &node->strings );
+	node->start_char = NULL;
+	stree_pool_free( &arena->nodes, node );
+}
+
+/* Create a new leaf or interleaf
+* Parameter:  arena:       the arena of the tree
+*             str_id:      the ID of the new string
+*             str_start:   the starting index of the new string
+*                          corresponding to the sequence on the 
+*                          path from the root to this node
+*             edgelen:     the number of charaters on the edge
+*             char_depth:  the charater depth, which equals to
+*                          the length of the sequence on the 
+*                          path from the root to this node
+*             c:           pointer to the string on the edge
+*             isinterleaf: INTERLEAF or LEAF
+*             node_count:  the total number of nodes in tree
+* Return:     pointer to the created node, NULL if fails
+* Last modified:  10/18/2026
+*/
+
+NODE * stree_new_leaf( STREE_ARENA *arena, unsigned int str_id, unsigned int str_start,
+	unsigned int edgelen, unsigned int char_depth,
+	char *c, int isinterleaf, unsigned int *node_count)
+{
+	NODE *NewLeaf;
+	if( ( NewLeaf = stree_alloc_node( arena, isinterleaf ? INTERLEAF : LEAF ) ) != NULL ){
+		if( stree_posting_append( arena, &NewLeaf->strings, str_id, str_start ) == 0 ){
+			/*For INTERLEAF, the string on the edge is NULL */
+			NewLeaf->start_char = isinterleaf ? NULL : c;  
+			NewLeaf->edgelen = edgelen;
+			NewLeaf->char_depth = char_depth;
+			NewLeaf->stringid_num++;
+			NewLeaf->node_num = ++( *node_count );
+		}
+		else{
+			printf( "Error: new leaf allocation fail!" );
+			stree_pool_free( &arena->nodes, NewLeaf );
+			NewLeaf = NULL;
+		}
+	}
+
+	return NewLeaf;
+}
+
+/* Make room at the end of the text buffer for a string of
+* len characters and its ending 0. When the buffer moves, the
+* edge labels of all the nodes are moved with it.
+* Parameter: tree:   the SUFFIXTREE
+*            len:    the length of the string
+* Return:    pointer to where the string is to be written
+*            NULL, if fails
+* Last modified: 10/18/2026
+*/
+
+char *stree_reserve_text( SUFFIXTREE *tree, unsigned int len )
+{
+	STREE_CHUNK *c;
+	NODE *node, *end;
+	char *text;
+	unsigned int *offset;
+	unsigned int size;
+
+	if( tree->text_len + len + 1 > tree->text_size ){
+		for( size = tree->text_size != 0 ? tree->text_size : 4096; size < tree->text_len + len + 1; size *= 2 );
+		if( ( text = ( char * )malloc( size ) ) == NULL )
+			return NULL;
+		if( tree->text_len != 0 ){
+			memcpy( text, tree->text, tree->text_len );
+			/* rebase the edge labels of every node in the pool */
+			for( c = tree->arena.nodes.chunks; c != NULL; c = c->next ){
+				node = ( NODE * )( c + 1 );
+				end = c == tree->arena.nodes.chunks ? ( NODE * )tree->arena.nodes.next_item : node + c->size / sizeof( NODE );
+				for( ; node < end; node++ ){
+					if( node->start_char != NULL )
+						node->start_char = text + ( node->start_char - tree->text );
+				}
+			}
+		}
+		free( tree->text );
+		tree->text = text;
+		tree->text_size = size;
+	}
+	if( tree->strnum + 2 > tree->offset_size ){
+		size = tree->offset_size != 0 ? tree->offset_size * 2 : 1024;
+		if( ( offset = ( unsigned int * )realloc( tree->str_offset, sizeof( unsigned int ) * size ) ) == NULL )
+			return NULL;
+		tree->str_offset = offset;
+		tree->offset_size = size;
+	}
+	return tree->text + tree->text_len;
+}
+
+
+/* Check if the string ID -str_id- already exists
+* in the node.
+* Parameter:  list:   the posting list of the node.
+*             str_id: the string ID in search.
+* Return:     0       If str_id in node
+*             1       otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_check_stringid( POSTING *list, unsigned int str_id )
+{
+	/* When the ID need not to be checked */
+	if( str_id == 0 ) 
+		return 0;
+	return !stree_posting_find( list, str_id );
+}
+
+/* Find the CHILD_STRUCT of the edge starting with c in a
+* child index
+* Last modified: 10/18/2026
+*/
+
+CHILD_STRUCT * stree_index_find( CHILD_INDEX *index, unsigned char c )
+{
+	unsigned int lo, hi, mid;
+
+	if( index->kind == CHILD_DIRECT )
+		return index->slots[c];
+	if( index->kind == CHILD_SMALL ){
+#ifdef __SSE2__
+		int mask;
+		mask = _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_loadu_si128( ( __m128i * )index->keys ),
+			_mm_set1_epi8( ( char )c ) ) ) & ( ( 1 << index->count ) - 1 );
+		return mask != 0 ? index->slots[__builtin_ctz( mask )] : NULL;
+#else
+		for( lo = 0; lo < index->count; lo++ ){
+			if( index->keys[lo] == c )
+				return index->slots[lo];
+		}
+		return NULL;
+#endif
+	}
+	lo = 0;
+	hi = index->count;
+	while( lo < hi ){
+		mid = ( lo + hi ) / 2;
+		if( index->keys[mid] < c )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < index->count && index->keys[lo] == c ? index->slots[lo] : NULL;
+}
+
+/* Find the CHILD_STRUCT of the edge with the largest
+* starting character below c in a child index
+* Return:     the CHILD_STRUCT, NULL if c is the smallest
+* Last modified: 10/18/2026
+*/
+
+CHILD_STRUCT * stree_index_pred( CHILD_INDEX *index, unsigned char c )
+{
+	CHILD_STRUCT *t = NULL;
+	unsigned int i, best, lo, hi, mid;
+
+	if( index->kind == CHILD_DIRECT ){
+		for( i = c; i > 0 && t == NULL; i-- )
+			t = index->slots[i-1];
+		return t;
+	}
+	if( index->kind == CHILD_SMALL ){
+		for( i = 0, best = 0; i < index->count; i++ ){
+			if( index->keys[i] < c && ( t == NULL || index->keys[i] > best ) ){
+				best = index->keys[i];
+				t = index->slots[i];
+			}
+		}
+		return t;
+	}
+	lo = 0;
+	hi = index->count;
+	while( lo < hi ){
+		mid = ( lo + hi ) / 2;
+		if( index->keys[mid] < c )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo > 0 ? index->slots[lo-1] : NULL;
+}
+
+/* Rebuild the child index of a node from its child list,
+* choosing the kind of index by the fan-out
+* Parameter:  arena:  the arena of the tree
+*             parent: the node
+*             count:  the number of children with a non-empty edge
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_index_build( STREE_ARENA *arena, NODE *parent, unsigned int count )
+{
+	CHILD_INDEX *index;
+	CHILD_STRUCT *t;
+	unsigned int kind, max;
+
+	kind = count <= CHILD_SMALL_MAX ? CHILD_SMALL : count <= CHILD_SORTED_MAX ? CHILD_SORTED : CHILD_DIRECT;
+	max = kind == CHILD_SMALL ? CHILD_SMALL_MAX : kind == CHILD_SORTED ? CHILD_SORTED_MAX : 0;
+	if( ( index = ( CHILD_INDEX * )stree_pool_alloc( &arena->index[kind] ) ) == NULL )
+		return 1;
+	index->kind = kind;
+	index->count = 0;
+	if( kind == CHILD_DIRECT ){
+		index->keys = NULL;
+		index->slots = ( CHILD_STRUCT ** )( index + 1 );
+		memset( ( void * )index->slots, 0, 256 * sizeof( CHILD_STRUCT * ) );
+	}
+	else{
+		index->keys = ( unsigned char * )( index + 1 );
+		index->slots = ( CHILD_STRUCT ** )( index->keys + max );
+		memset( ( void * )index->keys, 0, max );
+	}
+	/* the list is sorted, so the keys come out ascending */
+	for( t = parent->children; t != NULL; t = t->next ){
+		if( EMPTY_EDGE( t->child ) )
+			continue;
+		if( kind == CHILD_DIRECT )
+			index->slots[( unsigned char )t->child->start_char[0]] = t;
+		else{
+			index->keys[index->count] = ( unsigned char )t->child->start_char[0];
+			index->slots[index->count] = t;
+		}
+		index->count++;
+	}
+	if( parent->child_index != NULL )
+		stree_pool_free( &arena->index[parent->child_index->kind], parent->child_index );
+	parent->child_index = index;
+	return 0;
+}
+
+/* Add a newly linked child to the child index of its parent,
+* creating or growing the index when the fan-out requires
+* Parameter:  arena:  the arena of the tree
+*             parent: the parent node
+*             slot:   the CHILD_STRUCT of the new child
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_index_add( STREE_ARENA *arena, NODE *parent, CHILD_STRUCT *slot )
+{
+	CHILD_INDEX *index = parent->child_index;
+	CHILD_STRUCT *t;
+	unsigned int count, i;
+	unsigned char c;
+
+	if( index == NULL ){
+		for( t = parent->children, count = 0; t != NULL; t = t->next ){
+			if( !EMPTY_EDGE( t->child ) )
+				count++;
+		}
+		return count > CHILD_LIST_MAX ? stree_index_build( arena, parent, count ) : 0;
+	}
+	c = ( unsigned char )slot->child->start_char[0];
+	if( index->kind == CHILD_DIRECT ){
+		index->slots[c] = slot;
+		index->count++;
+		return 0;
+	}
+	if( index->count == ( index->kind == CHILD_SMALL ? CHILD_SMALL_MAX : CHILD_SORTED_MAX ) )
+		return stree_index_build( arena, parent, index->count + 1 );
+	if( index->kind == CHILD_SMALL ){
+		index->keys[index->count] = c;
+		index->slots[index->count] = slot;
+	}
+	else{
+		for( i = index->count; i > 0 && index->keys[i-1] > c; i-- ){
+			index->keys[i] = index->keys[i-1];
+			index->slots[i] = index->slots[i-1];
+		}
+		index->keys[i] = c;
+		index->slots[i] = slot;
+	}
+	index->count++;
+	return 0;
+}
+
+/* Get the CHILD_STRUCT of the child node whose
+* edge starts with character c
+* Parameter:  parent: the parent node
+*             c:      the starting character
+* Return:     pointer to the CHILD_STRUCT if there
+*             is an edge starts with c from parent,
+*             NULL otherwise. 
+* Last modified: 10/18/2026
+*/
+
+CHILD_STRUCT * stree_get_child( NODE *parent, char c )
+{
+	CHILD_STRUCT *t;
+	if( parent->child_index != NULL )
+		return stree_index_find( parent->child_index, ( unsigned char )c );
+	SKIP_INTERLEAF
+		while( t != NULL && t->child->start_char[0] != c )
+			t = t->next;
+	return t;
+}
+
+/* Insert the child node into the parent node
+* Parameter:  arena:      the arena of the tree
+*             parent:     the parent node 
+*             child:      the node to be inserted
+*             node_count: the total number of nodes in the tree 
+* Return:     If the node with the string ID already exists,return
+*             it and free child.Otherwise, return the new inserted
+*             node. If fails, return NULL
+* Last modified: 10/18/2026
+*/
+
+NODE * stree_insert_child( STREE_ARENA *arena, NODE *parent, NODE *child, unsigned int *node_count)
+{
+	CHILD_STRUCT *newChild, *p, *t;
+	unsigned char c;
+
+	if( child->start_char == NULL ){  
+		/* the child node is INTERLEAF */
+		if( parent->children->child->node_type != INTERLEAF ){ 
+			/*No INTEALEAF in the parent node. (A node has only oneINTERLEAF child node) */
+			if( ( newChild = stree_new_child_struct( arena, child, parent->children ) ) == NULL )  
+				return NULL;
+			parent->children = newChild;
+			child->parent = parent;
+			return child;
+		}
+		/* INTERLEAF exists, check string ID */
+		if( stree_check_stringid( &parent->children->child->strings, child->strings.last_id ) ){
+			if( stree_posting_append( arena, &parent->children->child->strings,
+				child->strings.last_id, child->strings.last_start ) ){
+				return NULL;
+			}
+			parent->stringid_num++;
+		}
+		stree_free_node( arena, child );
+		( *node_count )--;
+		return parent->children->child;
+	}
+
+	/* the child node is a normal LEAF, check if it already exists */
+	c = ( unsigned char )child->start_char[0];
+	p = NULL;
+	if( parent->child_index != NULL ){
+		if( ( p = stree_index_pred( parent->child_index, c ) ) == NULL && EMPTY_EDGE( parent->children->child ) ){
+			/* keep the empty edge at the head of the list */
+			p = parent->children;
+		}
+		t = p != NULL ? p->next : parent->children;
+	}
+	else{
+		SKIP_INTERLEAF
+		if( t != parent->children ){
+			/* keep the INTERLEAF at the head of the list */
+			p = parent->children;
+		}
+		while( t != NULL && ( unsigned char )t->child->start_char[0] < c ){
+			p = t;
+			t = t->next;
+		}
+	}
+		if( t != NULL && ( unsigned char )t->child->start_char[0] == c && 
+			stree_check_stringid( &t->child->strings, child->strings.last_id ) ){
+				if( stree_posting_append( arena, &t->child->strings, child->strings.last_id, child->strings.last_start ) ){
+					return NULL;
+				}
+				parent->stringid_num++;
+				stree_free_node( arena, child );
+				( *node_count )--;
+				return t->child;
+		}
+		/* Does not exist, insert into parent node */
+		if( ( newChild = stree_new_child_struct( arena, child, t ) ) == NULL ){
+			return NULL;
+		}
+		if( p == NULL ){
+			parent->children = newChild;
+		}
+		else{
+			p->next = newChild;
+		}
+		child->parent = parent;
+		if( stree_index_add( arena, parent, newChild ) )
+			return NULL;
+		return child;
+}
+
+/* Unlink a child from its parent and free its CHILD_STRUCT; the
+* child node is not freed. The child index of the parent is dropped
+* when the fan-out gets small again.
+* Parameter:  arena:  the arena of the tree
+*             parent: the parent node
+*             child:  the child to unlink
+* Last modified: 10/18/2026
+*/
+
+void stree_remove_child( STREE_ARENA *arena, NODE *parent, NODE *child )
+{
+	CHILD_INDEX *index = parent->child_index;
+	CHILD_STRUCT *p, *t;
+	unsigned int i;
+	unsigned char c;
+
+	p = NULL;
+	if( index != NULL && !EMPTY_EDGE( child ) ){
+		c = ( unsigned char )child->start_char[0];
+		if( ( p = stree_index_pred( index, c ) ) == NULL && parent->children->child != child ){
+			/* the empty edge at the head of the list */
+			p = parent->children;
+		}
+		if( index->kind == CHILD_DIRECT )
+			index->slots[c] = NULL;
+		else{
+			for( i = 0; index->keys[i] != c; i++ );
+			if( index->kind == CHILD_SMALL ){
+				index->keys[i] = index->keys[index->count-1];
+				index->slots[i] = index->slots[index->count-1];
+			}
+			else{
+				for( ; i + 1 < index->count; i++ ){
+					index->keys[i] = index->keys[i+1];
+					index->slots[i] = index->slots[i+1];
+				}
+			}
+		}
+		if( --index->count <= CHILD_LIST_MAX ){
+			stree_pool_free( &arena->index[index->kind], index );
+			parent->child_index = NULL;
+		}
+		t = p != NULL ? p->next : parent->children;
+	}
+	else{
+		for( t = parent->children; t->child != child; t = t->next )
+			p = t;
+	}
+	assert( t->child == child );
+	if( p == NULL )
+		parent->children = t->next;
+	else
+		p->next = t->next;
+	stree_pool_free( &arena->children, t );
+}
+
+/* Split the edge of child and link node onto it
+* Parameter:  arena:      the arena of the tree
+*             node:       the node to be linked
+*             child:      the node whose edge is to be split
+*             edgeindex:  the index when the last charater
+*                         check failed 
+*             node_count: the total number of nodes in tree
+* Return:     0   if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/ 
+
+int stree_link_node( STREE_ARENA *arena, NODE *node, NODE *child, unsigned int edgeindex, unsigned int *node_count)
+{
+	CHILD_STRUCT *t;
+	NODE *parent;
+	assert( ( parent = child->parent ) );
+	if( stree_insert_child( arena, node, child, node_count ) == NULL )   
+		return 1;
+
+	/*find the pointer in the parent that points to the
+	child and modify it */
+	t = stree_get_child( parent, child->start_char[0] );
+	assert( t );
+	//  if(stree_add_stringid(&node->strings,child->strings)) return 1;
+	t->child = node;
+	node->start_char = child->start_char;
+	node->edgelen = edgeindex + 1;
+	node->char_depth = child->char_depth - child->edgelen + node->edgelen;
+	node->parent = parent;
+	node->node_num = ++( *node_count );
+	//node->stringid_num = child->stringid_num + 1; 
+ 
+	child->start_char = &( child->start_char[edgeindex+1] );
+	child->edgelen -= node->edgelen;
+	//  if (child->edgelen==0) child->node_type=INTERLEAF;
+	return 0;
+}
+
+/* Check if character c exists on the edge of
+* the parent node when the current index is in
+* the middle of the edge, or if c exists on any
+* path under parent node when the current index
+* is the last character of the edge.
+* Parameter: parent:    the node to be checked
+*            newnode:   the node where c exists
+*            edgeindex: the current index
+*            newindex:  the index of c
+*            str_id:    the ID of the string in search
+*            c:         the character in search
+* Return:    0   c is found with the correct string id
+*            1   c is found, but with wrong string id
+*            2   c is not found
+* Last modified: 10/18/2026
+*/
+
+int stree_check_next(NODE *parent, NODE **newnode,
+	int edgeindex, int *newindex, unsigned int str_len,
+	unsigned int str_id, char c)
+{
+	CHILD_STRUCT *t;
+
+	if( edgeindex >= ( int )parent->edgelen - 1 ){ 
+		/* the current index is the last character */
+		if( parent->node_type == LEAF && c == 0 ) 
+			return 1;
+		t = parent->children;
+		if( t != NULL && c == 0 ){ 
+			/* the character in search is the null ending symbol */
+			if( t->child->node_type == INTERLEAF || ( t->child->node_type == LEAF && t->child->edgelen == 0 ) ){
+				return stree_check_stringid( &t->child->strings, str_id );
+			}
+		}
+		t = stree_get_child( parent, c );
+		/* For INTERNODE, don't check string ID. The string ID 
+		consistency will be fixed after the whole string is added */
+		if( t == NULL || ( t->child->node_type == INTERLEAF && stree_check_stringid( &t->child->strings, str_id ) ) )  
+			return 2;
+		/* the new index is the first character on the corresponding edge */
+		*newnode = t->child;
+		*newindex = 0;
+		return 0;
+	}
+	/* the current index is in the middle of the edge,
+	check the next character on the edge */
+	if( parent->start_char[edgeindex+1] != c )   
+		return 2;
+	*newindex = edgeindex + 1;
+	*newnode = parent;
+	return 0;
+}
+
+/* walk down the path from the start node according to the string 
+* Parameter:  start:  the node under which the walk starts
+*             string: the query string
+*             len:    the number of characters to walk
+*             str_id: the ID of the string
+* Return:     the node on whose edge the walk ends,
+*             NULL if the string is empty or len less than 1
+* Last modified: 6/27/2002
+*/
+
+NODE * stree_walk_down( NODE *start, char *string, unsigned int len, unsigned int str_id )
+{
+	unsigned int i;
+	int n;
+	NODE *p,*t;
+	if( string == NULL && len < 1 ) 
+		return NULL;
+	for( i = 0, n = start->edgelen - 1, p = start; i < len; i++, p = t ){
+		if( stree_check_next( p, &t, n, &n, len, str_id, string[i] ) )
+			return NULL;
+	}
+	return p;
+}
+
+NODE * stree_walk_and_fill( NODE *start, char *string, unsigned int len, int *s, int size )
+{
+	unsigned int i;
+	int n;
+	NODE *p, *t;
+	if( string == NULL && len < 1 ) 
+		return NULL;
+	for( i = 0 , n = start->edgelen - 1, p = start; i < len; i++, p = t ){
+		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) )
+			return NULL;
+		if( n == t->edgelen - 1 ){
+			if( t->node_type == LEAF || t->children->child->node_type == INTERLEAF ){
+				s[size-i-1] = TRUE;
+			}
+		}		  
+	}
+	if( n == p->edgelen - 1 && p->node_type == LEAF )
+		return NULL;
+	return p;
+}	
+
+NODE * stree_walk_and_report( NODE *start, char *string,
+	unsigned int len, int *s, int size, int nid)
+{
+	unsigned int i;
+	int n;
+	NODE *p, *t;
+	if( string == NULL && len < 1 ) 
+		return NULL;
+	for( i = 0, n = start->edgelen - 1, p = start; i < len; i++, p = t ){
+		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) )
+			return NULL;
+		if( n == t->edgelen - 1 ){
+			if( t->node_type == LEAF || t->children->child->node_type == INTERLEAF ){
+				if( s[i+1] == TRUE ){
+					printf( "The pattern occurs at index %d in node %d\n", size - i, nid );
+				}
+			}
+		}		  
+	}
+	if( n == p->edgelen - 1 && p->node_type == LEAF )
+		return NULL;
+	return p;
+}	
+
+/* the skip-count trick used in the tree construction.
+* similar to stree_walk_down, but no string ID check
+* and matching on a edge base
+* Parameter:  start:     the node under which the match starts
+*             string:    the query string
+*             edgeindex: pointer to new edge index (for return)
+*             len:       the number of characters to match
+* Return:     the node on whose edge the match ends and set
+*             the corresponding edge index
+* Last modified: 6/27/2002
+*/
+
+NODE * stree_skip_count( NODE *start, char *string, int *edgeindex, int len )
+{
+	int n, i;
+	NODE *p, *t;
+	assert( string != NULL );
+	if( len <= 0 ){
+		*edgeindex = start->edgelen - 1;
+		return start;
+	}
+	for( i = 0, n = start->edgelen - 1, p = start;	i < len; i += t->edgelen, p = t, n = t->edgelen - 1 ){
+		if( stree_check_next( p, &t, n, &n, len, 0, string[i] ) == 2 ) 
+			break;
+	}
+	*edgeindex = p->edgelen - ( i - len ) - 1;
+	return p;
+}
+
+/* the follow suffix link trick used in the tree construction
+* Parameter: last:      the new leaf or new internode
+*            edgeindex: the current edge index 
+*            newleaf:   1 if last is a leaf just hung under its
+*                       parent, 0 if the walk ended at the end
+*                       of the edge of last
+* Return:    the node where the next query should start with
+*            and set the corresponding current edge index
+* Last modified: 10/18/2026
+*/
+
+NODE * stree_follow_suffix( NODE *last, int *edgeindex, int newleaf )
+{
+	NODE *s, *child, *parent;
+	parent = last->parent;
+	s = parent->suffix_link;
+	if( last->node_type != INTERNODE && newleaf ){ 
+		/* if a new leaf or interleaf, always query from the 
+		internode to which th suffix link points */ 
+		child = s;
+		*edgeindex = s->edgelen - 1;
+	}
+	else{
+		if( parent->char_depth != s->char_depth ){
+			/* if parent is not the root */
+			child = stree_skip_count( s, last->start_char, edgeindex, last->edgelen );
+		}
+		else{
+			child = stree_skip_count( s, last->start_char + 1, edgeindex, last->edgelen - 1 );
+		}
+	}
+	return child;
+}
+
+/* Insert a new string into the suffix tree.
+* Parameter: tree:   the SUFFIXTREE 
+*            string: the new string
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_insert_string( SUFFIXTREE *tree, char *string )
+{
+	return stree_insert_string_len( tree, string, strlen( string ) );
+}
+
+/* Insert a new string of known length into the suffix tree.
+* Parameter: tree:   the SUFFIXTREE 
+*            string: the new string, which must not contain a 0
+*            len:    the length of the string
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_insert_string_len( SUFFIXTREE *tree, char *string, unsigned int len )
+{
+	char *text;
+	if( ( text = stree_reserve_text( tree, len ) ) == NULL )
+		return 1;
+	memcpy( text, string, len );
+	return stree_commit_string( tree, len );
+}
+
+/* Start a new string of the tree, empty, with the active point
+* at the root. The text buffer must have room for its offset.
+* Return:     0 if successful, 1 otherwise
+*/
+
+static int stree_builder_open( STREE_BUILDER *b )
+{
+	SUFFIXTREE *tree = b->tree;
+
+	if( tree->arena.nodes.item_size == 0 )
+		stree_arena_init( &tree->arena );
+	if( tree->strnum == 0 ){/* no string exists, create new tree */
+		if( ( tree->root = stree_alloc_node( &tree->arena, INTERNODE ) ) == NULL ) 
+			return 1; 
+		tree->root->suffix_link = tree->root->parent = tree->root;
+		tree->node_count = tree->root->node_num = 1;
+	}
+	tree->str_offset[tree->strnum] = tree->text_len;
+	tree->strnum++;
+	tree->str_offset[tree->strnum] = tree->text_len + 1;
+	b->open = 1;
+	b->len = 0;
+	b->lastnode = tree->root;
+	b->edgeindex = -1;
+	b->lastindex = 0;
+	b->suffix_update = NULL;
+	b->leaf_num = 0;
+	return 0;
+}
+
+/* One phase of Ukkonen's algorithm: extend the suffixes of the
+* string at last, from the active point of b, by the character at
+* index i. len is the length of the string, or -1 while it is open;
+* the leaves of an open string end at STREE_OPEN_END and are kept
+* in b->leaf until the length is known.
+* Return:     0 if successful, 1 otherwise
+*/
+
+static int stree_builder_step( STREE_BUILDER *b, char *last, int i, int len )
+{
+	SUFFIXTREE *tree = b->tree;
+	int j, tag, p, newindex;
+	unsigned int edgelen, char_depth;
+	NODE *childnode, *newleaf, *newnode, *leaf, **l;
+
+	tag = 0;
+	for( j = b->lastindex; j <= i; j++ ){
+		if( j == len ){
+			if(	tag && b->suffix_update != NULL ){
+				b->suffix_update->suffix_link = b->lastnode;
+			}
+			break;
+		}
+
+		if( ( p = stree_check_next( b->lastnode, &childnode, b->edgeindex, &newindex,
+			len, tree->strnum, last[i] ) ) == 0 ){ /*in tree */
+				if( tag && b->suffix_update != NULL ){
+					b->suffix_update->suffix_link = b->lastnode;
+					tag = 0;
+				}
+				b->edgeindex = newindex;
+				b->lastnode = childnode;
+				break;
+		}
+		else{ 
+			if( p == 1 ){
+				/* the suffix ends at a leaf, the new string ID is the largest */
+				leaf = b->lastnode->node_type == LEAF ? b->lastnode : b->lastnode->children->child;
+				assert( stree_check_stringid( &leaf->strings, tree->strnum ) == 1 );
+				leaf->stringid_num++;
+				if( stree_posting_append( &tree->arena, &leaf->strings, tree->strnum, len - b->lastnode->char_depth ) )
+					return 1;
+				if( tag && b->suffix_update != NULL ){
+					b->suffix_update->suffix_link = b->lastnode;
+					tag = 0;
+				}
+			}
+			else{
+				/* the new leaf hangs at depth i - j and its edge starts at last[i] */
+				if( len < 0 ){
+					edgelen = STREE_OPEN_END;
+					char_depth = i - j + STREE_OPEN_END;
+				}
+				else{
+					edgelen = i == len ? 0 : len - i;
+					char_depth = len - j;
+				}
+				if( ( newleaf = stree_new_leaf( &tree->arena, tree->strnum, j, edgelen, char_depth,
+					&last[i], i == len, &tree->node_count ) ) == NULL ){
+						return 1;
+				}
+				if( len < 0 ){
+					if( b->leaf_num == b->leaf_size ){
+						if( ( l = ( NODE ** )realloc( b->leaf, sizeof( NODE * ) * ( b->leaf_size != 0 ? 2 * b->leaf_size : 1024 ) ) ) == NULL )
+							return 1;
+						b->leaf = l;
+						b->leaf_size = b->leaf_size != 0 ? 2 * b->leaf_size : 1024;
+					}
+					b->leaf[b->leaf_num++] = newleaf;
+				}
+
+				if( b->edgeindex < ( int ) b->lastnode->edgelen - 1 || b->lastnode->node_type == LEAF ){
+					if( ( newnode = stree_alloc_node( &tree->arena, INTERNODE ) ) == NULL ) 
+						return 1;
+					stree_link_node( &tree->arena, newnode, b->lastnode, b->edgeindex, &tree->node_count );
+					if( tag && b->suffix_update != NULL ){
+						b->suffix_update->suffix_link = newnode;
+					}
+					tag = 1;
+					b->suffix_update = newnode;
+					if( stree_insert_child( &tree->arena, newnode, newleaf, &tree->node_count ) == NULL ) 
+						return 1;
+					b->lastnode = newnode;
+				}
+				else{
+					if( tag && b->suffix_update != NULL ){
+						b->suffix_update -> suffix_link = b->lastnode;
+						tag = 0;
+					}
+					b->lastnode = stree_insert_child( &tree->arena, b->lastnode, newleaf, &tree->node_count );
+				}
+			}
+			b->lastindex = j + 1;
+			b->lastnode = stree_follow_suffix( b->lastnode, &b->edgeindex, p == 2 );
+		}
+	}
+	return 0;
+}
+
+/* Insert the string written by the caller at the end of the
+* text buffer, after a stree_reserve_text of at least len.
+* Parameter: tree:   the SUFFIXTREE 
+*            len:    the length of the string
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_commit_string( SUFFIXTREE *tree, unsigned int len )
+{
+	STREE_BUILDER b;
+	char *last;
+	int i;
+
+	stree_builder_init( &b, tree );
+	if( stree_builder_open( &b ) )
+		return 1;
+	last = tree->text + tree->text_len;
+	last[len] = 0;
+	tree->text_len += len + 1;
+	tree->str_offset[tree->strnum] = tree->text_len;
+	for( i = 0; i <= ( int )len; i++ ){
+		if( i == ( int )len && b.lastnode == tree->root && b.edgeindex == -1 ){
+			break;
+		}
+		if( stree_builder_step( &b, last, i, len ) )
+			return 1;
+	}
+	//  stree_fix_stringid_suffixlink(tree,tree->strnum);
+	return 0;
+}
+
+/* Initialize a builder of the strings of a tree. The strings
+* may be inserted by stree_insert_string too, but not while one
+* is open in the builder.
+* Parameter: b:    the STREE_BUILDER
+*            tree: the SUFFIXTREE
+* Last modified: 10/18/2026
+*/
+
+void stree_builder_init( STREE_BUILDER *b, SUFFIXTREE *tree )
+{
+	memset( ( void * )b, 0, sizeof( STREE_BUILDER ) );
+	b->tree = tree;
+}
+
+/* Free the builder, not its tree. An open string must be ended
+* first, as its leaves get their lengths only then.
+* Last modified: 10/18/2026
+*/
+
+void stree_builder_free( STREE_BUILDER *b )
+{
+	free( b->leaf );
+	stree_builder_init( b, b->tree );
+}
+
+/* Append characters to the open string, which is started by the
+* first append after stree_builder_init or stree_builder_end_string.
+* Each character is added to the tree as it comes, in amortized O(1),
+* and the tree is then the implicit suffix tree of the string so far.
+* Parameter: b:       the STREE_BUILDER
+*            symbols: the characters, none of which may be 0
+*            n:       the number of characters
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_builder_append( STREE_BUILDER *b, const char *symbols, unsigned int n )
+{
+	SUFFIXTREE *tree = b->tree;
+	char *text, *last;
+	unsigned int i;
+
+	if( ( text = stree_reserve_text( tree, n ) ) == NULL )
+		return 1;
+	if( !b->open && stree_builder_open( b ) )
+		return 1;
+	memcpy( text, symbols, n );
+	text[n] = 0;
+	tree->text_len += n;
+	tree->str_offset[tree->strnum] = tree->text_len + 1;
+	last = tree->text + tree->str_offset[tree->strnum - 1];
+	for( i = b->len; i < b->len + n; i++ ){
+		if( stree_builder_step( b, last, i, -1 ) )
+			return 1;
+	}
+	b->len += n;
+	return 0;
+}
+
+/* End the open string: the suffixes still implicit get their
+* leaves, and the leaves of the string their lengths. Ending with
+* no string open inserts an empty one.
+* Parameter: b: the STREE_BUILDER
+* Return:    If successful, return 0.
+*            Otherwise, return 1.
+* Last modified: 10/18/2026
+*/
+
+int stree_builder_end_string( STREE_BUILDER *b )
+{
+	SUFFIXTREE *tree = b->tree;
+	char *last;
+	NODE *leaf;
+	unsigned int k, edgelen;
+
+	if( !b->open && ( stree_reserve_text( tree, 0 ) == NULL || stree_builder_open( b ) ) )
+		return 1;
+	last = tree->text + tree->str_offset[tree->strnum - 1];
+	last[b->len] = 0;
+	tree->text_len++;
+	tree->str_offset[tree->strnum] = tree->text_len;
+	if( ( b->lastnode != tree->root || b->edgeindex != -1 ) && stree_builder_step( b, last, b->len, b->len ) )
+		return 1;
+	for( k = 0; k < b->leaf_num; k++ ){
+		leaf = b->leaf[k];
+		edgelen = &last[b->len] - leaf->start_char;
+		leaf->char_depth = leaf->char_depth - leaf->edgelen + edgelen;
+		leaf->edgelen = edgelen;
+	}
+	b->leaf_num = 0;
+	b->open = 0;
+	return 0;
+}
+
+/* Check if a pattern occurs in the strings of the tree, the
+* open one included. Valid between appends.
+* Parameter: b:       the STREE_BUILDER
+*            pattern: the pattern
+*            len:     the length of the pattern
+* Return:    1 if it occurs, 0 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_builder_contains( STREE_BUILDER *b, char *pattern, unsigned int len )
+{
+	return b->tree->root != NULL && stree_walk_down( b->tree->root, pattern, len, 0 ) != NULL;
+}
+
+/* Count the occurrences of a pattern in the strings of the tree,
+* the open one included. Valid between appends: the suffixes of the
+* open string in a leaf are counted under the locus of the pattern.
+* The ones still implicit, from b->lastindex on, are the suffixes of
+* the active string, and the pattern is matched along it once with
+* the failure function, in O(len + its length).
+* Parameter: b:       the STREE_BUILDER
+*            pattern: the pattern
+*            len:     the length of the pattern
+* Return:    the number of occurrences
+* Last modified: 10/18/2026
+*/
+
+unsigned int stree_builder_count( STREE_BUILDER *b, char *pattern, unsigned int len )
+{
+	SUFFIXTREE *tree = b->tree;
+	STREE_OCC_ITER it;
+	STRINGID s;
+	vector< unsigned int > fail;
+	unsigned int n, j, k;
+	char *last;
+
+	n = 0;
+	if( tree->root == NULL )
+		return 0;
+	if( stree_occ_begin( tree, pattern, len, &it ) == 0 ){
+		while( stree_occ_next( &it, &s ) )
+			n++;
+	}
+	if( !b->open || b->lastindex + len > b->len )
+		return n;
+	if( len == 0 )
+		return n + b->len - b->lastindex + 1;
+	fail.resize( len );
+	fail[0] = 0;
+	for( j = 1, k = 0; j < len; j++ ){
+		while( k > 0 && pattern[j] != pattern[k] )
+			k = fail[k - 1];
+		if( pattern[j] == pattern[k] )
+			k++;
+		fail[j] = k;
+	}
+	last = tree->text + tree->str_offset[tree->strnum - 1];
+	for( j = b->lastindex, k = 0; j < b->len; j++ ){
+		while( k > 0 && last[j] != pattern[k] )
+			k = fail[k - 1];
+		if( last[j] == pattern[k] )
+			k++;
+		if( k == len ){
+			n++;
+			k = fail[k - 1];
+		}
+	}
+	return n;
+}
+
+/* Get a string of the tree by its ID. The pointer is valid
+* until the next string is inserted.
+* Parameter: t:      the SUFFIXTREE
+*            str_id: the ID of the string, from 1
+* Return:    the string, NULL if there is no such string or
+*            it was evicted
+* Last modified: 10/18/2026
+*/
+
+char *stree_find_string( SUFFIXTREE *t, unsigned int str_id )
+{
+	if( str_id <= t->str_evicted || str_id > t->strnum ) 
+		return NULL;
+	return t->text + t->str_offset[str_id - 1];
+}
+
+/* Get the offset of a string in the text buffer of the tree
+* Last modified: 10/18/2026
+*/
+
+unsigned int stree_string_offset( SUFFIXTREE *t, unsigned int str_id )
+{
+	return t->str_offset[str_id - 1];
+}
+
+/* Get the length of a string of the tree
+* Last modified: 10/18/2026
+*/
+
+unsigned int stree_string_length( SUFFIXTREE *t, unsigned int str_id )
+{
+	return t->str_offset[str_id] - t->str_offset[str_id - 1] - 1;
+}
+
+struct stree_leaf_printer{
+	SUFFIXTREE *tree;
+	int operator()( NODE *node )
+	{
+		if( node->node_type == INTERNODE )
+			return STREE_WALK_NEXT;
+		stree_graph_node( node, tree );
+		return STREE_WALK_SKIP;
+	}
+};
+
+void stree_print_leaf( NODE *node, SUFFIXTREE *tree )
+{
+	stree_leaf_printer v = { tree };
+	stree_walk_pre( node, v );
+}
+
+void stree_print_suffix( SUFFIXTREE *t )
+{
+	printf( "\n\n\n\t\t\t\t\t|************************************|\n" );
+	printf( "\t\t\t\t\t Printing all the suffix in the tree:\n" );
+	printf( "\t\t\t\t\t|************************************|\n\n\n" );
+	stree_print_leaf( t->root, t );
+}
+
+void stree_print_suffix_withid( SUFFIXTREE *t, unsigned int str_id )
+{
+	char *c = stree_find_string( t, str_id );
+	printf( "\n\nPrinting the suffix of string %d:\n", str_id );
+	stree_print_suffix_node( t->root,str_id, c);
+}
+
+int stree_print_tree( SUFFIXTREE *t )
+{
+	stree_print_subtree( t->root, t );
+	return 0;
+}
+
+struct stree_subtree_printer{
+	SUFFIXTREE *tree;
+	int enter( NODE *node, const char *path, unsigned int len )
+	{
+		stree_graph_node( node, tree );
+		printf( "the path is  " );
+		fwrite( path, 1, len, stdout );
+		printf( "\n" );
+		return STREE_WALK_NEXT;
+	}
+	void leave( NODE *, const char *, unsigned int ){}
+};
+
+int stree_print_subtree( NODE *node, SUFFIXTREE *t )
+{
+	stree_subtree_printer v = { t };
+	stree_walk_paths( t, node, v );
+	return 0;
+}
+
+int stree_graph_node( NODE *node, SUFFIXTREE *tree )
+{
+	STRINGID t;
+	CHILD_STRUCT *c;
+	unsigned int i, pos, edgelen;
+	edgelen = EDGE_LENGTH( tree, node );
+	printf( "|" );
+	for( i = 0 ; i < 80; i++ )
+		printf( "*" );
+	printf( "|" );
+	printf( "\nNode # %d:\n", node->node_num );
+	printf( "Node Type: %s\n", node_name[node->node_type] );
+	printf( "String Num: %d\n", node->stringid_num );
+	if( node->start_char != NULL ){
+		printf( "Character(s) on the edge:\t\t " );
+		for( i = 0; i < edgelen; i++ )
+			printf( "%c", node->start_char[i] );
+		printf( "\n" );
+	}
+	else{
+		printf( "There are no characters on this edge\n" );
+	}
+	printf( "Edge length is %d\n", edgelen );
+	printf( "the depth of character is %d\n", NODE_DEPTH( tree, node ) );
+	for( pos = 0; stree_posting_next( &node->strings, &pos, &t ); ){
+		if( node->node_type == INTERNODE )
+			printf( "the first appearance is %d in string %d\n", t.str_start, t.str_id );
+		else
+			printf( "The corresponding suffix is\t\t %s\n Starts from index %d in string %d\n",
+			stree_find_string( tree, t.str_id ) + t.str_start, t.str_start, t.str_id );
+	}
+	if( node->node_type == INTERNODE )
+		printf( "The suffix-link points to node %d\n", node->suffix_link->node_num );
+	if( node->node_type == INTERNODE ){
+		printf( "\n" );
+		for( i = 0, c = node->children; c != NULL; c = c->next, i++ ){
+			printf( "\t\tthe %d child is node %d\n", i, c->child->node_num);
+		}
+		printf( "\n" );
+	}
+	printf( "The parent node is %d\n", node->parent->node_num );
+	return 0;
+}  
+
+struct stree_suffix_printer{
+	unsigned int str_id;
+	char *string;
+	int operator()( NODE *node )
+	{
+		STRINGID s;
+		unsigned int pos;
+		if( node->node_type == INTERNODE )
+			return STREE_WALK_NEXT;
+		for( pos = 0; stree_posting_next( &node->strings, &pos, &s ) && s.str_id < str_id; );
+		if( pos != 0 && s.str_id == str_id ){
+			printf( "Starting position %4d:\t%s\n", s.str_start, &string[s.str_start] );
+		}
+		return STREE_WALK_SKIP;
+	}
+};
+
+int stree_print_suffix_node( NODE *node, unsigned int str_id, char *string )
+{
+	stree_suffix_printer v = { str_id, string };
+	stree_walk_pre( node, v );
+	return 0;
+}
+
+/* Add the string IDs of t to those of p, once for each string
+* with its smallest starting index
+* Parameter:  arena:  the arena of the tree
+*             p:      the posting list of parent, one STRINGID
+*                     for each string
+*             t:      the posting list to add
+*             parent: the node of p, whose stringid_num is increased
+*                     by the number of new strings
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_add_stringid( STREE_ARENA *arena, POSTING *p, POSTING *t, NODE *parent )
+{
+	POSTING merged, *lists[2];
+	lists[0] = p;
+	lists[1] = t;
+	if( stree_posting_union( arena, &merged, lists, 2, 1 ) )
+		return 1;
+	parent->stringid_num += merged.count - p->count;
+	stree_posting_free( arena, p );
+	*p = merged;
+	return 0;
+}
+
+NODE * stree_next_suffix( NODE *node, unsigned int str_id )
+{
+	NODE *parent, *t;
+	if( node->node_type == INTERNODE ){
+		t = node->suffix_link;
+	}
+	else{
+		parent = node->parent;
+		if( node->node_type == INTERLEAF ){
+			t = parent->suffix_link;
+		}
+		else{
+			if( parent->char_depth != parent->suffix_link->char_depth ){
+				t = stree_walk_down( parent->suffix_link, node->start_char,	node->edgelen,str_id );
+			}
+			else{
+				if( node->edgelen > 1 ){
+					t = stree_walk_down( parent->suffix_link, node->start_char + 1, node->edgelen - 1, str_id );
+				}
+				else{
+					return parent->suffix_link;
+				}
+			}
+		}
+	}
+	if( t->node_type == INTERNODE && t->node_num != 1 )
+		t = t->children->child;
+	assert( t );
+	return t;  
+}
+
+int stree_test( SUFFIXTREE *tree )
+{
+	NODE *t;
+	char *c;
+	c = stree_find_string( tree, 2 );
+	t = stree_walk_down( tree->root, c, strlen( c ), 2 );
+	while( t != tree->root ){
+		printf( "Node #:\t %d\n", t->node_num );
+		t = stree_next_suffix( t, 2 );
+	}
+	return 0;
+}
+
+int stree_query_string( SUFFIXTREE *t, char *string )
+{
+	NODE *start;
+	if( ( start = stree_walk_down( t->root, string, strlen( string ), 0 ) ) == NULL )
+		return 1;
+	stree_print_leaf( start, t );
+	return 0;
+}
+
+/* Start the enumeration of the occurrences of a pattern
+* Parameter:  t:      the SUFFIXTREE
+*             string: the pattern
+*             len:    the length of the pattern
+*             it:     the cursor (for return)
+* Return:     0 if the pattern occurs, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_occ_begin( SUFFIXTREE *t, char *string, unsigned int len, STREE_OCC_ITER *it )
+{
+	NODE *node;
+	CHILD_STRUCT *c = NULL;
+	it->root = it->node = NULL;
+	it->slot = NULL;
+	it->pos = 0;
+	if( t->root == NULL || ( node = stree_walk_down( t->root, string, len, 0 ) ) == NULL )
+		return 1;
+	it->root = node;
+	while( node->node_type == INTERNODE ){
+		c = node->children;
+		node = c->child;
+	}
+	it->node = node;
+	it->slot = c;
+	return 0;
+}
+
+/* Report the next occurrence, as the ID of the string and the
+* index in it where the pattern starts
+* Parameter:  it: the cursor from stree_occ_begin
+*             s:  the occurrence (for return)
+* Return:     1 if s is set, 0 after the last occurrence
+* Last modified: 10/18/2026
+*/
+
+int stree_occ_next( STREE_OCC_ITER *it, STRINGID *s )
+{
+	NODE *node;
+	CHILD_STRUCT *c;
+	while( ( node = it->node ) != NULL ){
+		if( stree_posting_next( &node->strings, &it->pos, &it->last ) ){
+			*s = it->last;
+			return 1;
+		}
+		/* climb to the first ancestor with a next child */
+		it->pos = 0;
+		for( c = it->slot; node != it->root && c->next == NULL; ){
+			node = node->parent;
+			c = node == it->root ? NULL : stree_get_child( node->parent, node->start_char[0] );
+		}
+		if( node == it->root ){
+			it->node = NULL;
+			return 0;
+		}
+		/* and down to the leftmost leaf under that child */
+		c = c->next;
+		node = c->child;
+		while( node->node_type == INTERNODE ){
+			c = node->children;
+			node = c->child;
+		}
+		it->node = node;
+		it->slot = c;
+	}
+	return 0;
+}
+
+/* Copy up to size occurrences into a buffer of the caller. The
+* cursor is left after the last one copied, so the call continues
+* where it stopped until it returns less than size.
+* Parameter:  it:   the cursor from stree_occ_begin
+*             out:  the buffer (for return)
+*             size: the number of entries in out
+* Return:     the number of occurrences copied
+* Last modified: 10/18/2026
+*/
+
+unsigned int stree_occ_fill( STREE_OCC_ITER *it, STRINGID *out, unsigned int size )
+{
+	unsigned int n;
+	for( n = 0; n < size && stree_occ_next( it, &out[n] ); n++ );
+	return n;
+}
+
+/* Count the occurrences of a pattern and the strings it occurs
+* in, in O(length of the pattern). The counts of the internal nodes
+* are those set by stree_count_strings (or fix_stringid).
+* Parameter:  t:             the SUFFIXTREE
+*             string:        the pattern
+*             len:           the length of the pattern
+*             embedding_num: the number of occurrences (for return)
+*             stringid_num:  the number of strings (for return)
+* Return:     0 if the pattern occurs, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_count_occurrences( SUFFIXTREE *t, char *string, unsigned int len,
+	unsigned int *embedding_num, unsigned int *stringid_num )
+{
+	NODE *node;
+	*embedding_num = *stringid_num = 0;
+	if( t->root == NULL || ( node = stree_walk_down( t->root, string, len, 0 ) ) == NULL )
+		return 1;
+	if( node->node_type != INTERNODE ){
+		/* a leaf holds one STRINGID for each string */
+		*embedding_num = *stringid_num = node->strings.count;
+	}
+	else{
+		*embedding_num = node->embedding_num;
+		*stringid_num = node->stringid_num;
+	}
+	return 0;
+}
+
+void stree_fill_leaf( NODE *node, int *s )
+{
+}
+
+int stree_fill_pattern( SUFFIXTREE *p, char *string, int *s, int size)
+{
+	NODE *start;
+	if( ( start = stree_walk_and_fill( p->root, string, strlen( string ), s, size ) ) == NULL )
+		return 1;
+	stree_fill_leaf( start, s );
+	return 0;
+}
+
+int stree_report_occurence( SUFFIXTREE *p, char *string, int *s, int size, int nid )
+{
+	NODE *start;
+	if( ( start = stree_walk_and_report( p->root, string, strlen( string ), s, size,nid ) ) == NULL )
+		return 1;
+	stree_print_leaf( start, p );
+	return 0;
+}
+
+int stree_print_path( SUFFIXTREE *tree, NODE *t )
+{
+	vector< char > path;
+	unsigned int len = stree_walk_path_of( tree, t, path );
+	fwrite( &path[0], 1, len, stdout );
+	return 0;
+}
+
+int whichclass( int a, int *b )
+{
+	int i;
+	for( i = 0; a > b[i]; a -= b[i++] );
+	return i;
+}
+
+/* Report the signature substring of one node */
+static void stree_sigstring_node( NODE *t, int *idclass, const char *path, unsigned int len )
+{
+	int i, count[CLASSMAX] = {0}, max_index, secmax_index;
+	double max, secmax;
+	STRINGID p;
+	unsigned int pos;
+	for( i = 0 , pos = 0; i < t->stringid_num - 1 && stree_posting_next( &t->strings, &pos, &p ); i++ ){
+		count[whichclass( ( p.str_id ), idclass )]++;
+	}
+	max = ( double )count[0] / ( double )idclass[0];
+	max_index = 0;
+	secmax = -1;
+	for( i = 1 ;i<CLASSMAX; i++ ){
+		if( ( double ) count[i] / ( double )idclass[i] > max ){
+			secmax = max;
+			secmax_index = max_index;
+			max = ( double )count[i] / ( double )idclass[i];
+			max_index = i;
+		}
+		else{
+			if( ( double ) count[i] / ( double )idclass[i] > secmax){
+				secmax = ( double ) count[i] / ( double )idclass[i];
+				secmax_index = i;
+			}
+		}
+	}
+	if (/*max>=HIGHLEVL&&secmax<=LOWLEVL&&*/max * ( double ) idclass[max_index] >= 75 ){
+		printf( "\nThe signature substring for class %d is ", max_index + 1 );
+		fwrite( path, 1, len, stdout );
+		printf(" with %.0f instances.\n", max*(double)idclass[max_index]);
+	}
+}
+
+struct stree_sigstring_reporter{
+	NODE *root;
+	int *idclass;
+	int enter( NODE *node, const char *path, unsigned int len )
+	{
+		if( node != root && node->node_type != INTERNODE &&
+			( node->node_type != LEAF || node->edgelen == 0 ) )
+			return STREE_WALK_SKIP;
+		stree_sigstring_node( node, idclass, path, len );
+		return STREE_WALK_NEXT;
+	}
+	void leave( NODE *, const char *, unsigned int ){}
+};
+
+int stree_sigstring_report( SUFFIXTREE *tree, NODE *t, int *idclass )
+{
+	stree_sigstring_reporter v = { t, idclass };
+	stree_walk_paths( tree, t, v );
+	return 0;
+}
+
+int check_stringid_integrity( NODE *t )
+{
+	return t->strings.count == t->stringid_num ? 1 : 0;
+}
+
+/* Merge the string IDs of the children of t, and report it if no
+* node below was
+* Return:     1 if t or a node below was reported, 0 otherwise
+*/
+static int stree_fix_subtree_node( SUFFIXTREE *tree, NODE *t, int *idclass, int ptag,
+	const char *path, unsigned int len )
+{
+	int i, count[CLASSMAX] = {0}, max_index, secmax_index;
+	double max, secmax;
+	STRINGID p;
+	unsigned int pos;
+	CHILD_STRUCT * child;
+
+	for( child = t->children; child != NULL; child = child->next ){
+		stree_add_stringid( &tree->arena, &t->strings, &child->child->strings, t );
+		if( !check_stringid_integrity ( t ) ){
+			printf( "Stringid number incorrect in node %d!\n", t->node_num );
+		}
+	}
+	if( ptag == 0 ){
+		for( i = 0, pos = 0; i < t->stringid_num && stree_posting_next( &t->strings, &pos, &p ); i++){
+			count[whichclass( ( p.str_id ), idclass )]++;
+		}
+
+		max = ( double )count[0] / ( double )idclass[0];
+		max_index = 0;
+		secmax = -1;
+
+		for( i = 1; i < CLASSMAX; i++ ){
+			if( ( double )count[i] / ( double )idclass[i] > max ){
+				secmax = max;
+				secmax_index = max_index;
+				max = ( double )count[i] / ( double )idclass[i];
+				max_index = i;
+			}
+			else{
+				if( ( double )count[i] / ( double )idclass[i] > secmax){
+					secmax = ( double )count[i] / ( double )idclass[i];
+					secmax_index = i;
+				}
+			}
+		}
+		if (/*max>=HIGHLEVL&&secmax<=LOWLEVL&&*/ max * ( double ) idclass[max_index] >= 500 ){
+
+			printf( "\n%d\t", max_index + 1 );
+			fwrite( path, 1, len, stdout );
+			printf( "\t%.0f\t %.2f\t %.2f\n", max * ( double )idclass[max_index], max, secmax );
+			ptag = 1;  
+		}										
+	}
+	return ptag;
+}
+
+struct stree_subtree_id_fixer{
+	SUFFIXTREE *tree;
+	NODE *root;
+	int *idclass;
+	vector< int > ptag;         /*the tags of the open internal nodes*/
+	int enter( NODE *node, const char *, unsigned int )
+	{
+		if( node != root && node->node_type != INTERNODE )
+			return STREE_WALK_SKIP;
+		ptag.push_back( 0 );
+		return STREE_WALK_NEXT;
+	}
+	void leave( NODE *node, const char *path, unsigned int len )
+	{
+		int tag;
+		if( node != root && node->node_type != INTERNODE )
+			return;
+		tag = stree_fix_subtree_node( tree, node, idclass, ptag.back(), path, len );
+		ptag.pop_back();
+		if( !ptag.empty() )
+			ptag.back() += tag;
+		else
+			ptag.push_back( tag );
+	}
+};
+
+int stree_fix_subtree_id( SUFFIXTREE *tree, NODE *t, int *idclass )
+{
+	stree_subtree_id_fixer v;
+	v.tree = tree;
+	v.root = t;
+	v.idclass = idclass;
+	stree_walk_paths( tree, t, v );
+	return v.ptag.back();
+}
+
+/*add all the string ids to its parent, including all the occurences of the same substring
+* Last modified: 10/18/2026
+*/
+int add_stringid( STREE_ARENA *arena, POSTING *p, POSTING *t, NODE *parent )
+{
+	POSTING merged, *lists[2];
+	lists[0] = p;
+	lists[1] = t;
+	if( stree_posting_union( arena, &merged, lists, 2, 0 ) )
+		return 1;
+	stree_posting_free( arena, p );
+	*p = merged;
+	return 0;
+}
+
+int get_stringid_num( NODE* t )
+{
+	int num = 0;
+	STRINGID p;
+	unsigned int pos, last;
+	for( pos = 0, last = 0; stree_posting_next( &t->strings, &pos, &p ); last = p.str_id ){
+		if( p.str_id != last )
+			num++;
+	}
+	return num ;
+}
+
+int get_embedding_num( NODE* t )
+{
+	return t->strings.count;
+}
+
+// fix the string id of each node of the tree when multiple occurences of substring are taken into consideration.
+// bottom-up method, the children's ids are merged into the parent's in one pass.
+struct stree_stringid_fixer{
+	SUFFIXTREE *tree;
+	NODE *root;
+	vector< POSTING * > lists;
+	int ret;
+	void operator()( NODE *t )
+	{
+		POSTING merged;
+		CHILD_STRUCT * child;
+
+		if( ( t != root && t->node_type != INTERNODE ) || ret != 0 )
+			return;
+		lists.clear();
+		lists.push_back( &t->strings );
+		for( child = t->children; child != NULL; child = child->next )
+			lists.push_back( &child->child->strings );
+		if( stree_posting_union( &tree->arena, &merged, &lists[0], lists.size(), 0 ) ){
+			ret = 1;
+			return;
+		}
+		stree_posting_free( &tree->arena, &t->strings );
+		t->strings = merged;
+		t->stringid_num =  get_stringid_num( t );
+		t->embedding_num = get_embedding_num( t );
+	}
+};
+
+int fix_stringid( SUFFIXTREE *tree, NODE *t )
+{
+	stree_stringid_fixer v;
+	v.tree = tree;
+	v.root = t;
+	v.ret = 0;
+	stree_walk_post( t, v );
+	return v.ret;
+}
+#define STREE_NIL  0xFFFFFFFFu
+
+/* An open node of the counting walk */
+typedef struct stree_count_frame{
+	unsigned int entry;         /*the visiting order of the node*/
+	unsigned int occ;           /*the suffixes of its subtree so far*/
+	unsigned int dup;           /*repeated strings among them*/
+	NODE *node;
+	CHILD_STRUCT *next;         /*the next child to visit*/
+}STREE_COUNT_FRAME;
+
+/* Set stringid_num and embedding_num of every node from the leaves
+* alone, without merging any string ID list (Hui's color set size).
+* The leaves are visited depth first; each time a string shows up
+* again, the repeat is subtracted at the lowest common ancestor of
+* its two leaves: the deepest open node visited before the earlier
+* leaf, found by binary search on the open path. A node's string
+* count is then its occurrences less the repeats in its subtree.
+* Only the open path and one entry per string are kept. Unlike
+* fix_stringid, the posting lists of the internal nodes stay empty;
+* stree_node_strings produces one on demand.
+* Parameter:  tree: the SUFFIXTREE
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_count_strings( SUFFIXTREE *tree )
+{
+	vector< STREE_COUNT_FRAME > stack;
+	vector< unsigned int > last;
+	STREE_COUNT_FRAME f;
+	CHILD_STRUCT *c;
+	NODE *node;
+	STRINGID s;
+	unsigned int entry, lo, hi, mid, pos;
+
+	if( tree->root == NULL )
+		return 1;
+	last.assign( tree->strnum + 1, STREE_NIL );
+	node = tree->root;
+	entry = 0;
+	for( ; ; ){
+		if( node != NULL ){
+			/* first visit: count the suffixes of a leaf */
+			f.entry = entry++;
+			f.occ = f.dup = 0;
+			f.node = node;
+			f.next = node->children;
+			stack.push_back( f );
+			if( node->node_type != INTERNODE ){
+				for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); ){
+					stack.back().occ++;
+					if( last[s.str_id] != STREE_NIL ){
+						for( lo = 0, hi = stack.size(); hi - lo > 1; ){
+							mid = ( lo + hi ) / 2;
+							if( stack[mid].entry <= last[s.str_id] )
+								lo = mid;
+							else
+								hi = mid;
+						}
+						stack[lo].dup++;
+					}
+					last[s.str_id] = f.entry;
+				}
+			}
+			node = NULL;
+			continue;
+		}
+		if( stack.empty() )
+			break;
+		if( ( c = stack.back().next ) != NULL ){
+			stack.back().next = c->next;
+			node = c->child;
+			continue;
+		}
+		/* all children done: fold the subtree into the parent */
+		f = stack.back();
+		stack.pop_back();
+		f.node->embedding_num = f.occ;
+		f.node->stringid_num = f.occ - f.dup;
+		if( !stack.empty() ){
+			stack.back().occ += f.occ;
+			stack.back().dup += f.dup;
+		}
+	}
+	return 0;
+}
+
+/* Produce the posting list of a node from the leaves under it,
+* for a node whose list was not kept by stree_count_strings
+* Parameter:  tree:     the SUFFIXTREE
+*             node:     the node
+*             out:      the list (for return), to be released with
+*                       stree_posting_free
+*             distinct: 1 for one STRINGID for each string
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_node_strings( SUFFIXTREE *tree, NODE *node, POSTING *out, int distinct )
+{
+	vector< POSTING * > lists;
+	vector< NODE * > stack;
+	CHILD_STRUCT *c;
+
+	stack.push_back( node );
+	while( !stack.empty() ){
+		node = stack.back();
+		stack.pop_back();
+		if( node->node_type != INTERNODE )
+			lists.push_back( &node->strings );
+		for( c = node->children; c != NULL; c = c->next )
+			stack.push_back( c->child );
+	}
+	return stree_posting_union( &tree->arena, out, lists.empty() ? NULL : &lists[0], lists.size(), distinct );
+}
+
+/* Find, for every k from 2 to the number of strings, the longest
+* substring occurring in at least k strings. The node counts are
+* set by stree_count_strings; one more depth-first pass keeps the
+* deepest node of each count, with the first leaf under it as the
+* witness, and a suffix maximum over k finishes in O(n) overall.
+* Not while a string is open in an STREE_BUILDER.
+* Parameter:  tree: the SUFFIXTREE
+*             out:  strnum+1 entries, out[k] for k = 2 .. strnum
+*                   (for return)
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_k_common( SUFFIXTREE *tree, STREE_COMMON *out )
+{
+	vector< pair< NODE *, CHILD_STRUCT * > > stack;
+	vector< NODE * > first;     /*the first leaf under each open node*/
+	CHILD_STRUCT *c;
+	NODE *node, *leaf;
+	STRINGID s;
+	unsigned int k, n, pos;
+
+	if( tree->root == NULL || tree->str_offset[tree->strnum] != tree->text_len || stree_count_strings( tree ) )
+		return 1;
+	memset( ( void * )out, 0, sizeof( STREE_COMMON ) * ( tree->strnum + 1 ) );
+	stack.push_back( make_pair( tree->root, tree->root->children ) );
+	first.push_back( NULL );
+	while( !stack.empty() ){
+		if( ( c = stack.back().second ) != NULL ){
+			stack.back().second = c->next;
+			stack.push_back( make_pair( c->child, c->child->children ) );
+			first.push_back( c->child->node_type == INTERNODE ? NULL : c->child );
+			continue;
+		}
+		node = stack.back().first;
+		leaf = first.back();
+		stack.pop_back();
+		first.pop_back();
+		if( !first.empty() && first.back() == NULL )
+			first.back() = leaf;
+		n = node->stringid_num;
+		if( node != tree->root && n >= 2 && node->char_depth > out[n].length ){
+			pos = 0;
+			stree_posting_next( &leaf->strings, &pos, &s );
+			out[n].length = node->char_depth;
+			out[n].str_id = s.str_id;
+			out[n].str_start = s.str_start;
+			out[n].node = node;
+		}
+	}
+	/* a substring in more than k strings is also in k of them */
+	for( k = tree->strnum; k > 2; k-- ){
+		if( out[k].length > out[k-1].length )
+			out[k-1] = out[k];
+	}
+	return 0;
+}
+
+// travse the tree to find substring given a threshold sup
+// stringid_num comes from fix_stringid or, without the lists, stree_count_strings
+struct stree_substring_finder{
+	unsigned int min_sup;
+	NODE **output;
+	int *output_size;
+	int operator()( NODE *node )
+	{
+		if( node->stringid_num >= min_sup && node->char_depth != 0 ){
+			output[*output_size] = node;
+			(*output_size)++;
+		}
+		return STREE_WALK_NEXT;
+	}
+};
+
+int find_substring(  int min_sup, NODE *node, NODE *output[], int *output_size )
+{
+	stree_substring_finder v = { ( unsigned int )min_sup, output, output_size };
+	stree_walk_pre( node, v );
+	return 0;
+}
+
+static bool mined_greater( const STREE_MINED &a, const STREE_MINED &b )
+{
+	return a.score > b.score;
+}
+
+static bool frontier_less( const pair< double, NODE * > &a, const pair< double, NODE * > &b )
+{
+	return a.first < b.first;
+}
+
+/* Find the k substrings of highest score with support min_sup or
+* more. The nodes are expanded best first, by an upper bound of the
+* scores in their subtree, and the best k kept in a min-heap; the
+* walk ends when no bound left can beat the k-th score. The support
+* of a node bounds that of its subtree, and times the longest
+* string, its area. The node counts are those set by
+* stree_count_strings or fix_stringid. Nodes with an empty edge
+* repeat their parent and are left out.
+* Parameter:  tree:    the SUFFIXTREE
+*             k:       the number of substrings wanted
+*             min_sup: the least support
+*             score:   STREE_SCORE_SUPPORT, STREE_SCORE_AREA or
+*                      STREE_SCORE_USER
+*             fn:      the score of a node, for STREE_SCORE_USER
+*             bound:   a bound of fn over the subtree of a node, or
+*                      NULL to walk the whole tree
+*             arg:     passed to fn and bound
+*             out:     k entries, best first (for return)
+*             num:     the number of entries filled (for return)
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_top_k( SUFFIXTREE *tree, unsigned int k, unsigned int min_sup, int score,
+	STREE_SCORE_FN fn, STREE_SCORE_FN bound, void *arg, STREE_MINED *out, unsigned int *num )
+{
+	vector< STREE_MINED > heap;
+	vector< pair< double, NODE * > > frontier;
+	STREE_MINED m;
+	CHILD_STRUCT *c;
+	NODE *node;
+	double b, maxlen;
+	unsigned int i;
+
+	*num = 0;
+	if( tree->root == NULL || k == 0 || ( score == STREE_SCORE_USER && fn == NULL ) )
+		return 1;
+	for( i = 1, maxlen = 0; i <= tree->strnum; i++ ){
+		if( stree_string_length( tree, i ) > maxlen )
+			maxlen = stree_string_length( tree, i );
+	}
+	frontier.push_back( make_pair( HUGE_VAL, tree->root ) );
+	while( !frontier.empty() ){
+		pop_heap( frontier.begin(), frontier.end(), frontier_less );
+		b = frontier.back().first;
+		node = frontier.back().second;
+		frontier.pop_back();
+		if( heap.size() == k && b <= heap.front().score )
+			break;
+		if( node != tree->root ){
+			m.node = node;
+			m.length = NODE_DEPTH( tree, node );
+			m.support = node->stringid_num;
+			if( score == STREE_SCORE_SUPPORT )
+				m.score = m.support;
+			else if( score == STREE_SCORE_AREA )
+				m.score = ( double )m.support * m.length;
+			else
+				m.score = fn( arg, node );
+			if( heap.size() < k ){
+				heap.push_back( m );
+				push_heap( heap.begin(), heap.end(), mined_greater );
+			}
+			else if( m.score > heap.front().score ){
+				pop_heap( heap.begin(), heap.end(), mined_greater );
+				heap.back() = m;
+				push_heap( heap.begin(), heap.end(), mined_greater );
+			}
+		}
+		for( c = node->children; c != NULL; c = c->next ){
+			if( EMPTY_EDGE( c->child ) || c->child->stringid_num < min_sup )
+				continue;
+			if( score == STREE_SCORE_SUPPORT )
+				b = c->child->stringid_num;
+			else if( score == STREE_SCORE_AREA )
+				b = c->child->stringid_num * maxlen;
+			else
+				b = bound != NULL ? bound( arg, c->child ) : HUGE_VAL;
+			if( heap.size() == k && b <= heap.front().score )
+				continue;
+			frontier.push_back( make_pair( b, c->child ) );
+			push_heap( frontier.begin(), frontier.end(), frontier_less );
+		}
+	}
+	sort( heap.begin(), heap.end(), mined_greater );
+	for( i = 0; i < heap.size(); i++ )
+		out[i] = heap[i];
+	*num = heap.size();
+	return 0;
+}
+
+string get_substring( SUFFIXTREE *tree, NODE *s )
+{
+	vector< char > path;
+	unsigned int len = stree_walk_path_of( tree, s, path );
+	return string( &path[0], len );
+}
+
+/* Find the closed substrings of support min_sup or more: those with
+* no longer superstring of the same support. A longer superstring of
+* the same support gives one a character longer, on either side.
+* On the right it is the path of a child. On the left, if it ends
+* inside an edge, the next character is forced and the right side
+* already has one; otherwise it is the path of a node whose suffix
+* link, or for a leaf whose next suffix, is the substring. So each
+* node is checked against its children and the nodes linked to it,
+* in linear time. The result is that of get_closed_string over the
+* output of find_substring, nodes with an empty edge, which repeat
+* their parent, left out. The node counts are those set by
+* stree_count_strings or fix_stringid.
+* Parameter:  tree:        the SUFFIXTREE
+*             min_sup:     the least support
+*             output:      the closed nodes, in depth-first order
+*                          (for return)
+*             output_size: the number of nodes in output (for return)
+* Return:     0 if successful, 1 otherwise
+* Last modified: 10/18/2026
+*/
+
+int stree_closed_substring( SUFFIXTREE *tree, int min_sup, NODE *output[], int *output_size )
+{
+	vector< NODE * > stack, nodes;
+	vector< NODE * > at;        /*the node of the suffix at each text position*/
+	vector< char > closed;
+	CHILD_STRUCT *c;
+	NODE *node, *x;
+	STRINGID s;
+	unsigned int i, pos, p;
+
+	*output_size = 0;
+	if( tree->root == NULL )
+		return 1;
+	at.assign( tree->text_len + 1, ( NODE * )NULL );
+	closed.assign( tree->node_count + 1, 0 );
+	stack.push_back( tree->root );
+	while( !stack.empty() ){
+		node = stack.back();
+		stack.pop_back();
+		nodes.push_back( node );
+		if( node != tree->root && !EMPTY_EDGE( node ) )
+			closed[node->node_num] = 1;
+		if( node->node_type != INTERNODE ){
+			x = node->node_type == LEAF ? node : node->parent;
+			for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); )
+				at[tree->str_offset[s.str_id - 1] + s.str_start] = x;
+		}
+		for( c = node->children; c != NULL; c = c->next )
+			stack.push_back( c->child );
+	}
+	for( i = 0; i < nodes.size(); i++ ){
+		node = nodes[i];
+		if( node == tree->root || EMPTY_EDGE( node ) )
+			continue;
+		for( c = node->children; c != NULL; c = c->next ){
+			if( !EMPTY_EDGE( c->child ) && c->child->stringid_num == node->stringid_num )
+				closed[node->node_num] = 0;
+		}
+		if( node->node_type == INTERNODE ){
+			x = node->suffix_link;
+			if( x != NULL && x != tree->root && x->stringid_num == node->stringid_num )
+				closed[x->node_num] = 0;
+			continue;
+		}
+		for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); ){
+			p = tree->str_offset[s.str_id - 1] + s.str_start + 1;
+			x = at[p];
+			if( x != NULL && x->stringid_num == node->stringid_num )
+				closed[x->node_num] = 0;
+		}
+	}
+	for( i = 0; i < nodes.size(); i++ ){
+		node = nodes[i];
+		if( closed[node->node_num] && node->stringid_num >= ( unsigned int )min_sup )
+			output[( *output_size )++] = node;
+	}
+	return 0;
+}
+
+// compares every pair of nodes in input; over the whole tree
+// stree_closed_substring gives the same in linear time
+int get_closed_string( SUFFIXTREE *tree, NODE *input[], int input_size, NODE *output[], int* output_size )
+{
+	list<NODE*> node_list;
+	for( int i = 0; i < input_size; i ++ ){
+		node_list.push_front( input[i] );
+	}
+	
+	bool is_delete; 
+	list<NODE*>::iterator it1, it2, end;
+	string str1, str2;
+	it1 = node_list.begin();
+	end =  node_list.end();
+
+	while( it1 != end ){
+		is_delete = false;
+		it2 = it1;
+		++it2;
+		while( it2 != end ){
+			if( NODE_DEPTH( tree, *it1 ) > NODE_DEPTH( tree, *it2 ) ){ 
+				str1 = get_substring( tree, *it1 );
+				str2 = get_substring( tree, *it2 );
+				char *ptr= strstr( const_cast<char*>(str1.c_str()) , str2.c_str() );
+				if( ptr != NULL ){
+					if( (*it1)->stringid_num == (*it2)->stringid_num ){
+						NODE* t = *(it2);
+						++it2;
+						node_list.remove( t );
+						continue;
+					}
+				}
+			}
+			else if( NODE_DEPTH( tree, *it1 ) < NODE_DEPTH( tree, *it2 ) ){
+				str1 = get_substring( tree, *it1 );
+				str2 = get_substring( tree, *it2 );
+				char *ptr= strstr( const_cast<char*>(str2.c_str()) , str1.c_str() );
+				if( ptr != NULL ){
+					if( (*it1)->stringid_num == (*it2)->stringid_num ){
+						is_delete = true;
+						NODE* t = *(it1);
+						++it1;
+						node_list.remove( t );
+						break;
+					}
+				}
+			}
+			++it2;
+		}
+		if( is_delete == true )
+			continue;
+		++it1;
+	}
+
+	*output_size = 0;
+	for( it1 = node_list.begin(); it1 != node_list.end(); it1++ )
+	{
+		output[ (*output_size)++ ] = *it1;
+	}
+
+	return 0;
+}
+
+int get_closed_string( SUFFIXTREE *tree, NODE *input[], int input_size, list<NODE*> &node_list )
+{
+	for( int i = 0; i < input_size; i ++ ){
+		node_list.push_front( input[i] );
+	}
+	
+	bool is_delete; 
+	list<NODE*>::iterator it1, it2, end;
+	string str1, str2;
+	it1 = node_list.begin();
+	end =  node_list.end();
+
+	while( it1 != end ){
+		is_delete = false;
+		it2 = it1;
+		++it2;
+		while( it2 != end ){
+			if( NODE_DEPTH( tree, *it1 ) > NODE_DEPTH( tree, *it2 ) ){ 
+				str1 = get_substring( tree, *it1 );
+				str2 = get_substring( tree, *it2 );
+				char *ptr= strstr( const_cast<char*>(str1.c_str()) , str2.c_str() );
+				if( ptr != NULL ){
+					if( (*it1)->stringid_num == (*it2)->stringid_num ){
+						NODE* t = *(it2);
+						++it2;
+						node_list.remove( t );
+						continue;
+					}
+				}
+			}
+			else if( NODE_DEPTH( tree, *it1 ) < NODE_DEPTH( tree, *it2 ) ){
+				str1 = get_substring( tree, *it1 );
+				str2 = get_substring( tree, *it2 );
+				char *ptr= strstr( const_cast<char*>(str2.c_str()) , str1.c_str() );
+				if( ptr != NULL ){
+					if( (*it1)->stringid_num == (*it2)->stringid_num ){
+						is_delete = true;
+						NODE* t = *(it1);
+						++it1;
+						node_list.remove( t );
+						break;
+					}
+				}
+			}
+			++it2;
+		}
+		if( is_delete == true )
+			continue;
+		++it1;
+	}
+
+	return 0;
+}
+
+/*
+int get_closed_string( int sup, NODE *tar[], int num, NODE *init_can[], int* count )
+{
+	int i, j, flag;
+	NODE *p, *q;
+	STRINGID *pstr, *qstr, *pre;; 
+	for( i = 0; i < num; i++ ){
+		for( j = i+1; j < num; j++){
+			if( tar[i]->char_depth <= tar[j]->char_depth ){
+				p = tar[i];
+				q = tar[j];
+			}
+			else{
+				p = tar[j];
+				q = tar[i];
+			}
+			
+			pre = NULL;
+			pstr = p->strings;	
+			while( pstr != NULL ){
+				qstr = q->strings;
+				flag = 0;
+				while( qstr != NULL){
+					if( pstr->str_id < qstr->str_id )
+						break;
+					else if( pstr->str_id > qstr->str_id )
+						qstr = qstr->next;
+					else{
+						if( (pstr->str_start >= qstr->str_start) && ( pstr->str_start+p->char_depth <= qstr->str_start+q->char_depth ) ){
+							if( pre == NULL ){
+								pre = pstr;
+								p->strings = pstr->next;
+								pstr = p->strings;
+								free( pre );
+								pre = NULL;	
+							}
+							else{
+								pre->next = pstr->next;
+								free( pstr );
+								pstr = pre->next;
+							}
+							flag = 1;
+							break;
+						}
+						qstr = qstr->next;
+					}
+				}
+				if( flag != 1 ){
+					pre = pstr;
+					pstr = pstr->next;
+				}
+			}
+		}
+		if( get_stringid_num( tar[i] ) >= sup )
+			init_can[(*count)++] = tar[i];
+	}
+	return 0;
+}
+*/
+
+
+int stree_print_path_file( SUFFIXTREE *tree, NODE *t, FILE *fp )
+{
+	vector< char > path;
+	unsigned int len = stree_walk_path_of( tree, t, path );
+	fwrite( &path[0], 1, len, fp );
+	return 0;
+}
+
+
+
+
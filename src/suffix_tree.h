@@ -1,100 +1,320 @@
-#pragma once
-
-#include <string>
-#include <stdio.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <math.h>
-#include <algorithm> 
-#include <list>
-
-using namespace std;
-
-#define INTERNODE  0
-#define INTERLEAF  1
-#define LEAF       2
-
-
-#define TRUE  1
-#define FALSE 0
-
-#define STRNUM 20000
-#define CLASSNUM 2
-#define CLASSSIZE 5
-
-#define NAMEMAX 10
-#define SEQMAX  1000
-#define CLASSMAX 150
-
-#define HIGHLEVL 0.5
-#define LOWLEVL  0.3
-
-typedef struct rawstring{
-	char *string;
-	struct rawstring *next;
-}RAWSTRING;
-
-typedef struct stringid{
-	unsigned int str_id;
-	unsigned int str_start;
-	struct stringid *next;
-}STRINGID;
-
-typedef struct child_struct{
-	struct child_struct *next;
-	struct node *child;
-}CHILD_STRUCT;
-
-typedef struct node{
-	unsigned int node_num;
-	int node_type;          /*Internode; Interleaf; Leaf*/
-	char *start_char;
-	unsigned int edgelen;
-	unsigned int char_depth;
-	unsigned int stringid_num;
-	unsigned int embedding_num;
-	STRINGID *strings;
-	struct node *suffix_link;
-	CHILD_STRUCT *children;
-	struct node *parent;
-}NODE;
-
-typedef struct suffixtree{
-	unsigned int strnum;
-	RAWSTRING *raw;
-	NODE *root;
-	unsigned int node_count;
-}SUFFIXTREE;
-
-typedef struct classstats{
-	float occr;
-	int classid;
-}CLASSSTATS;
-static float fuzzyclass[STRNUM][CLASSMAX];
-
-#define SKIP_INTERLEAF t = parent->children != NULL && parent->children->child->node_type == INTERLEAF ? \
-                         parent->children->next : parent->children;
-
-int stree_insert_string( SUFFIXTREE *tree, char *string );
-char *stree_find_string( SUFFIXTREE *t, unsigned int str_id );
-void stree_print_leaf( NODE *node, SUFFIXTREE *tree );
-int stree_print_tree( SUFFIXTREE *t );
-int stree_print_subtree( NODE *node, SUFFIXTREE *t );
-int stree_graph_node( NODE *node, SUFFIXTREE *tree );
-int stree_print_suffix_node( NODE *node, unsigned int str_id, char *string );
-int stree_add_stringid( STRINGID **p, STRINGID *t, NODE *parent );
-int stree_query_string( SUFFIXTREE *t, char *string );
-int stree_print_path( NODE *t );
-int stree_sigstring_report(NODE *t,int *idclass);
-int check_stringid_integrity( NODE *t );
-int stree_fix_subtree_id( NODE *t, int *idclass );
-
-int add_stringid( STRINGID **p, STRINGID *t, NODE *parent );
-int get_stringid_num( NODE* t );
-int fix_stringid( NODE *t );
-int find_substring(  int min_sup, NODE *node, NODE *output[], int *output_size );
-int get_closed_string(  NODE *input[], int input_size, NODE *output[], int* output_size );
-int get_closed_string( NODE *input[], int input_size, list<NODE*> &node_list );
-int stree_print_path_file( NODE *t, FILE *fp );
-string get_substring( NODE *s );
-
+#pragma once
+
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <algorithm> 
+#include <list>
+
+using namespace std;
+
+#define INTERNODE  0
+#define INTERLEAF  1
+#define LEAF       2
+
+
+#define TRUE  1
+#define FALSE 0
+
+/* The class sizes read by stree_sigstring_report and stree_fix_subtree_id;
+* stree_signatures takes an STREE_CLASSES of any size */
+#define CLASSMAX 150
+
+#define HIGHLEVL 0.5
+#define LOWLEVL  0.3
+
+typedef struct stringid{
+	unsigned int str_id;
+	unsigned int str_start;
+}STRINGID;
+
+/* The STRINGIDs of a node, sorted by str_id then str_start and
+* stored as varint-coded deltas: the str_id delta, then str_start,
+* or its delta when the str_id repeats. Up to POSTING_INLINE bytes
+* are kept in the node itself, larger lists in a buffer of the arena.
+* A STRINGID with the largest str_id is appended in O(1).
+*/
+#define POSTING_INLINE   8
+#define POSTING_CLASSES  27     /*buffers of 16 << k bytes*/
+
+typedef struct posting{
+	union{
+		unsigned char *data;
+		unsigned char bytes[POSTING_INLINE];
+	};
+	unsigned int len;           /*bytes used*/
+	unsigned int count;         /*STRINGIDs stored*/
+	unsigned int last_id;
+	unsigned int last_start;
+}POSTING;
+
+#define POSTING_DATA( l ) ( ( l )->len <= POSTING_INLINE ? ( l )->bytes : ( l )->data )
+
+typedef struct child_struct{
+	struct child_struct *next;
+	struct node *child;
+}CHILD_STRUCT;
+
+/* Lookup index over the children of a node with a large fan-out.
+* The sorted CHILD_STRUCT list stays the authority for the order
+* of the children; the index only maps the first character of a
+* non-empty edge to its CHILD_STRUCT, so an INTERLEAF is never in it.
+*/
+#define CHILD_LIST_MAX    4     /*up to this many children, scan the list*/
+#define CHILD_SMALL_MAX   16    /*unordered keys, compared 16 at a time*/
+#define CHILD_SORTED_MAX  64    /*ascending keys, binary search*/
+
+#define CHILD_SMALL   0
+#define CHILD_SORTED  1
+#define CHILD_DIRECT  2         /*one slot for each of the 256 characters*/
+
+typedef struct child_index{
+	unsigned int kind;
+	unsigned int count;
+	unsigned char *keys;        /*NULL for CHILD_DIRECT*/
+	CHILD_STRUCT **slots;
+}CHILD_INDEX;
+
+typedef struct node{
+	unsigned int node_num;
+	int node_type;          /*Internode; Interleaf; Leaf*/
+	char *start_char;
+	unsigned int edgelen;
+	unsigned int char_depth;
+	unsigned int stringid_num;
+	unsigned int embedding_num;
+	POSTING strings;
+	struct node *suffix_link;
+	CHILD_STRUCT *children;
+	CHILD_INDEX *child_index;   /*NULL while the fan-out is small*/
+	struct node *parent;
+}NODE;
+
+/* Fixed-size item pool. Items are carved out of large chunks and
+* recycled through a free list, so a whole pool is released in
+* O(number of chunks). A zero-filled pool is valid; the item size
+* is set on first use.
+*/
+typedef struct stree_chunk{
+	struct stree_chunk *next;
+	size_t size;            /*usable bytes following the header*/
+}STREE_CHUNK;
+
+typedef struct stree_pool{
+	size_t item_size;
+	size_t chunk_size;
+	STREE_CHUNK *chunks;    /*chunks in use, newest first*/
+	STREE_CHUNK *spare;     /*chunks kept by stree_reset for reuse*/
+	char *next_item;
+	char *end;
+	void *free_list;
+	size_t chunk_count;
+}STREE_POOL;
+
+/* Per-tree allocator behind every NODE, CHILD_STRUCT, POSTING
+* buffer and CHILD_INDEX of a SUFFIXTREE */
+typedef struct stree_arena{
+	STREE_POOL nodes;
+	STREE_POOL children;
+	STREE_POOL posting[POSTING_CLASSES];
+	STREE_POOL index[3];    /*CHILD_INDEX of each kind*/
+}STREE_ARENA;
+
+/* All the strings are kept in one text buffer, each followed by
+* a 0, and the edge labels point into it. String i (1-based) starts
+* at text[str_offset[i-1]]; str_offset[strnum] is the text length.
+* Strings 1 to str_evicted were evicted by the sliding window and
+* have no suffixes left in the tree; when their text is dropped the
+* other strings are renumbered from 1, and str_base counts the
+* strings dropped so far, so str_id + str_base never changes. After
+* an eviction node_count is the largest node_num, not the number of
+* nodes, until the numbers are made dense again.
+*/
+typedef struct suffixtree{
+	unsigned int strnum;
+	unsigned int str_evicted;
+	unsigned int str_base;
+	char *text;
+	unsigned int text_len;
+	unsigned int text_size;
+	unsigned int *str_offset;
+	unsigned int offset_size;
+	NODE *root;
+	unsigned int node_count;
+	STREE_ARENA arena;
+}SUFFIXTREE;
+
+/* Online construction of one string at a time. The string being
+* built is the last one of the tree, open until stree_builder_end_string;
+* its characters are text[str_offset[strnum-1]] to text[text_len-1],
+* followed by a 0. The leaves of the open string end at STREE_OPEN_END
+* and get their lengths when the string is ended; EDGE_LENGTH and
+* NODE_DEPTH give them before. A string must be shorter than
+* STREE_OPEN_END.
+*/
+#define STREE_OPEN_END  0x40000000
+
+typedef struct stree_builder{
+	SUFFIXTREE *tree;
+	int open;                   /*1 while a string is being appended*/
+	unsigned int len;           /*the characters appended to it*/
+	NODE *lastnode;             /*the active point: a node and*/
+	int edgeindex;              /*the index on its edge*/
+	unsigned int lastindex;     /*the first suffix not in a leaf yet*/
+	NODE *suffix_update;        /*the internode waiting for a suffix link*/
+	NODE **leaf;                /*the leaves of the open string*/
+	unsigned int leaf_num;
+	unsigned int leaf_size;
+}STREE_BUILDER;
+
+#define STREE_FORMAT_AUTO   0     /*FASTA if the input starts with '>'*/
+#define STREE_FORMAT_LINES  1
+#define STREE_FORMAT_FASTA  2
+
+typedef struct stree_load_stats{
+	unsigned int strings;           /*strings inserted*/
+	unsigned long long bytes;       /*characters inserted*/
+	unsigned long long input_bytes; /*input consumed*/
+	double seconds;
+	double mb_per_sec;              /*input consumed per second*/
+}STREE_LOAD_STATS;
+
+/* Cursor over the occurrences of a pattern: the leaves under its
+* locus are visited depth first, with no allocation and no stdio */
+typedef struct stree_occ_iter{
+	NODE *root;             /*the locus of the pattern*/
+	NODE *node;             /*the leaf being reported, NULL when done*/
+	CHILD_STRUCT *slot;     /*the entry of node in its parent*/
+	unsigned int pos;       /*the position in the posting list of node*/
+	STRINGID last;          /*the STRINGID before pos*/
+}STREE_OCC_ITER;
+
+/* The longest substring occurring in at least k strings, with one
+* of its occurrences */
+typedef struct stree_common{
+	unsigned int length;        /*0 if no substring is in k strings*/
+	unsigned int str_id;
+	unsigned int str_start;
+	NODE *node;                 /*the node whose path it is*/
+}STREE_COMMON;
+
+/* Scores of stree_top_k */
+#define STREE_SCORE_SUPPORT  0  /*the number of strings*/
+#define STREE_SCORE_AREA     1  /*the number of strings times the length*/
+#define STREE_SCORE_USER     2  /*given by a STREE_SCORE_FN*/
+
+typedef double ( *STREE_SCORE_FN )( void *arg, NODE *node );
+
+typedef struct stree_mined{
+	NODE *node;                 /*get_substring( tree, node ) gives the substring*/
+	unsigned int length;
+	unsigned int support;
+	double score;
+}STREE_MINED;
+
+typedef struct classstats{
+	float occr;
+	int classid;
+}CLASSSTATS;
+
+#define SKIP_INTERLEAF t = parent->children != NULL && parent->children->child->node_type == INTERLEAF ? \
+                         parent->children->next : parent->children;
+#define EMPTY_EDGE( n ) ( ( n )->start_char == NULL || ( n )->edgelen == 0 )
+
+/* The edge length and depth of a node, for the leaves of a string
+* open in an STREE_BUILDER too: their depths start at STREE_OPEN_END,
+* and their labels end at the 0 that follows the characters appended
+* so far, which is text[text_len]. */
+#define OPEN_LEAF( n ) ( ( n )->char_depth >= STREE_OPEN_END )
+#define EDGE_LENGTH( t, n ) ( !OPEN_LEAF( n ) ? ( n )->edgelen : \
+                           ( unsigned int )( ( t )->text + ( t )->text_len - ( n )->start_char ) )
+#define NODE_DEPTH( t, n ) ( !OPEN_LEAF( n ) ? ( n )->char_depth : \
+                           ( n )->char_depth - ( n )->edgelen + ( unsigned int )( ( t )->text + ( t )->text_len - ( n )->start_char ) )
+
+void stree_init( SUFFIXTREE *tree );
+void stree_reset( SUFFIXTREE *tree );
+void stree_destroy( SUFFIXTREE *tree );
+size_t stree_memory_usage( SUFFIXTREE *tree );
+void *stree_pool_alloc( STREE_POOL *pool );
+void stree_pool_free( STREE_POOL *pool, void *item );
+void stree_pool_adopt( STREE_POOL *pool, STREE_POOL *from );
+
+/* construction helpers shared by the build modules */
+NODE *stree_alloc_node( STREE_ARENA *arena, int type );
+void stree_free_node( STREE_ARENA *arena, NODE *node );
+CHILD_STRUCT *stree_new_child_struct( STREE_ARENA *arena, NODE *child, CHILD_STRUCT *next );
+int stree_posting_append( STREE_ARENA *arena, POSTING *list, unsigned int str_id, unsigned int str_start );
+int stree_posting_next( POSTING *list, unsigned int *pos, STRINGID *s );
+int stree_posting_find( POSTING *list, unsigned int str_id );
+int stree_posting_union( STREE_ARENA *arena, POSTING *out, POSTING **lists, unsigned int num, int distinct );
+void stree_posting_free( STREE_ARENA *arena, POSTING *list );
+int stree_posting_pop( STREE_ARENA *arena, POSTING *list );
+int stree_posting_shift( STREE_ARENA *arena, POSTING *list, int delta );
+void stree_posting_lower( POSTING *list, unsigned int delta );
+int stree_check_stringid( POSTING *list, unsigned int str_id );
+CHILD_STRUCT * stree_get_child( NODE *parent, char c );
+NODE * stree_insert_child( STREE_ARENA *arena, NODE *parent, NODE *child, unsigned int *node_count );
+void stree_remove_child( STREE_ARENA *arena, NODE *parent, NODE *child );
+int stree_link_node( STREE_ARENA *arena, NODE *node, NODE *child, unsigned int edgeindex, unsigned int *node_count );
+NODE * stree_skip_count( NODE *start, char *string, int *edgeindex, int len );
+NODE * stree_walk_down( NODE *start, char *string, unsigned int len, unsigned int str_id );
+
+int stree_insert_string( SUFFIXTREE *tree, char *string );
+int stree_insert_string_len( SUFFIXTREE *tree, char *string, unsigned int len );
+char *stree_reserve_text( SUFFIXTREE *tree, unsigned int len );
+int stree_commit_string( SUFFIXTREE *tree, unsigned int len );
+void stree_builder_init( STREE_BUILDER *b, SUFFIXTREE *tree );
+void stree_builder_free( STREE_BUILDER *b );
+int stree_builder_append( STREE_BUILDER *b, const char *symbols, unsigned int n );
+int stree_builder_end_string( STREE_BUILDER *b );
+int stree_builder_contains( STREE_BUILDER *b, char *pattern, unsigned int len );
+unsigned int stree_builder_count( STREE_BUILDER *b, char *pattern, unsigned int len );
+int stree_load_fd( SUFFIXTREE *tree, int fd, int format,
+	unsigned int max_strings, unsigned long long max_bytes, STREE_LOAD_STATS *stats );
+int stree_load_file( SUFFIXTREE *tree, const char *path, int format,
+	unsigned int max_strings, unsigned long long max_bytes, STREE_LOAD_STATS *stats );
+int stree_merge( SUFFIXTREE *a, SUFFIXTREE *b );
+int stree_evict_string( SUFFIXTREE *tree );
+int stree_window_trim( SUFFIXTREE *tree, unsigned int max_strings, unsigned long long max_bytes );
+int stree_window_insert( SUFFIXTREE *tree, char *string, unsigned int len,
+	unsigned int max_strings, unsigned long long max_bytes );
+int stree_window_compact( SUFFIXTREE *tree );
+int stree_build_parallel( SUFFIXTREE *tree, char **strings, unsigned int num, int threads );
+char *stree_find_string( SUFFIXTREE *t, unsigned int str_id );
+unsigned int stree_string_offset( SUFFIXTREE *t, unsigned int str_id );
+unsigned int stree_string_length( SUFFIXTREE *t, unsigned int str_id );
+void stree_print_leaf( NODE *node, SUFFIXTREE *tree );
+int stree_print_tree( SUFFIXTREE *t );
+int stree_print_subtree( NODE *node, SUFFIXTREE *t );
+int stree_graph_node( NODE *node, SUFFIXTREE *tree );
+int stree_print_suffix_node( NODE *node, unsigned int str_id, char *string );
+int stree_add_stringid( STREE_ARENA *arena, POSTING *p, POSTING *t, NODE *parent );
+int stree_query_string( SUFFIXTREE *t, char *string );
+int stree_occ_begin( SUFFIXTREE *t, char *string, unsigned int len, STREE_OCC_ITER *it );
+int stree_occ_next( STREE_OCC_ITER *it, STRINGID *s );
+unsigned int stree_occ_fill( STREE_OCC_ITER *it, STRINGID *out, unsigned int size );
+int stree_count_occurrences( SUFFIXTREE *t, char *string, unsigned int len,
+	unsigned int *embedding_num, unsigned int *stringid_num );
+int stree_print_path( SUFFIXTREE *tree, NODE *t );
+int stree_sigstring_report( SUFFIXTREE *tree, NODE *t, int *idclass );
+int check_stringid_integrity( NODE *t );
+int stree_fix_subtree_id( SUFFIXTREE *tree, NODE *t, int *idclass );
+
+int add_stringid( STREE_ARENA *arena, POSTING *p, POSTING *t, NODE *parent );
+int get_stringid_num( NODE* t );
+int fix_stringid( SUFFIXTREE *tree, NODE *t );
+int stree_count_strings( SUFFIXTREE *tree );
+int stree_node_strings( SUFFIXTREE *tree, NODE *node, POSTING *out, int distinct );
+int stree_k_common( SUFFIXTREE *tree, STREE_COMMON *out );
+int find_substring(  int min_sup, NODE *node, NODE *output[], int *output_size );
+int stree_top_k( SUFFIXTREE *tree, unsigned int k, unsigned int min_sup, int score,
+	STREE_SCORE_FN fn, STREE_SCORE_FN bound, void *arg, STREE_MINED *out, unsigned int *num );
+int stree_closed_substring( SUFFIXTREE *tree, int min_sup, NODE *output[], int *output_size );
+int get_closed_string( SUFFIXTREE *tree, NODE *input[], int input_size, NODE *output[], int* output_size );
+int get_closed_string( SUFFIXTREE *tree, NODE *input[], int input_size, list<NODE*> &node_list );
+int stree_print_path_file( SUFFIXTREE *tree, NODE *t, FILE *fp );
+string get_substring( SUFFIXTREE *tree, NODE *s );
+
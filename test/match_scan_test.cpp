@@ -0,0 +1,193 @@
+/* Checks of the MEMs reported by the scanner of match_scan.h
+*
+*   g++ -std=c++11 -O2 -Isrc test/match_scan_test.cpp src/[a-z]*.cpp -lpthread
+*
+* A fixed case, random corpora against a brute-force search, and a
+* periodic corpus, whose long paths report few MEMs.
+* Exits with 1 on the first failure.
+*/
+
+#include "match_scan.h"
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static int test_on_mem( void *arg, const CTREE_MEM *mem, unsigned int num )
+{
+	vector< CTREE_MEM > *mems = ( vector< CTREE_MEM > * )arg;
+	mems->insert( mems->end(), mem, mem + num );
+	return 0;
+}
+
+static bool test_mem_less( const CTREE_MEM &a, const CTREE_MEM &b )
+{
+	if( a.qpos != b.qpos )
+		return a.qpos < b.qpos;
+	if( a.length != b.length )
+		return a.length < b.length;
+	if( a.str_id != b.str_id )
+		return a.str_id < b.str_id;
+	return a.str_start < b.str_start;
+}
+
+static bool test_mem_equal( const CTREE_MEM &a, const CTREE_MEM &b )
+{
+	return !test_mem_less( a, b ) && !test_mem_less( b, a );
+}
+
+/* The MEMs of query against strings, sorted; the query is fed in
+* pieces of at most piece characters */
+static int test_scan( vector< string > &strings, const string &query, unsigned int min_mem,
+	size_t piece, vector< CTREE_MEM > &out )
+{
+	SUFFIXTREE tree;
+	COMPACTTREE c;
+	CTREE_SCANNER s;
+	size_t pos, n;
+	unsigned int i;
+
+	stree_init( &tree );
+	for( i = 0; i < strings.size(); i++ )
+		stree_insert_string_len( &tree, ( char * )strings[i].c_str(), strings[i].size() );
+	if( ctree_build( &c, &tree ) ){
+		stree_destroy( &tree );
+		return 1;
+	}
+	stree_destroy( &tree );
+	out.clear();
+	if( ctree_scan_init( &s, &c, min_mem, NULL, test_on_mem, &out ) ){
+		ctree_free( &c );
+		return 1;
+	}
+	for( pos = 0; pos < query.size(); pos += n ){
+		n = min( piece, query.size() - pos );
+		if( ctree_scan_feed( &s, query.data() + pos, n ) )
+			break;
+	}
+	if( ctree_scan_finish( &s ) || pos < query.size() ){
+		ctree_scan_free( &s );
+		ctree_free( &c );
+		return 1;
+	}
+	ctree_scan_free( &s );
+	ctree_free( &c );
+	sort( out.begin(), out.end(), test_mem_less );
+	return 0;
+}
+
+/* The MEMs by comparing every position of the query with every
+* position of the strings */
+static void test_brute( vector< string > &strings, const string &query, unsigned int min_mem,
+	vector< CTREE_MEM > &out )
+{
+	CTREE_MEM m;
+	size_t q, j;
+	unsigned int d, l;
+
+	out.clear();
+	for( q = 0; q < query.size(); q++ ){
+		for( d = 0; d < strings.size(); d++ ){
+			for( j = 0; j < strings[d].size(); j++ ){
+				if( q > 0 && j > 0 && strings[d][j-1] == query[q-1] )
+					continue;
+				for( l = 0; q + l < query.size() && j + l < strings[d].size() &&
+					query[q+l] == strings[d][j+l]; l++ );
+				if( l < min_mem )
+					continue;
+				m.qpos = q;
+				m.length = l;
+				m.str_id = d + 1;
+				m.str_start = j;
+				out.push_back( m );
+			}
+		}
+	}
+	sort( out.begin(), out.end(), test_mem_less );
+}
+
+static int test_same( const char *name, vector< CTREE_MEM > &got, vector< CTREE_MEM > &want )
+{
+	if( got.size() == want.size() && equal( got.begin(), got.end(), want.begin(), test_mem_equal ) )
+		return 0;
+	printf( "%s: %u MEMs, %u expected\n", name, ( unsigned int )got.size(), ( unsigned int )want.size() );
+	return 1;
+}
+
+/* A match that leaves the path above its locus: ACGT of string 1
+* and ACG of string 2 both start at query position 0 */
+static int test_fixed( void )
+{
+	vector< string > strings;
+	vector< CTREE_MEM > got, want( 2 );
+
+	strings.push_back( "ACGT" );
+	strings.push_back( "ACGA" );
+	want[0].qpos = 0; want[0].length = 3; want[0].str_id = 2; want[0].str_start = 0;
+	want[1].qpos = 0; want[1].length = 4; want[1].str_id = 1; want[1].str_start = 0;
+	if( test_scan( strings, "ACGTT", 2, 5, got ) )
+		return 1;
+	return test_same( "ACGT ACGA / ACGTT", got, want );
+}
+
+static int test_random( void )
+{
+	vector< string > strings;
+	vector< CTREE_MEM > got, want;
+	string query;
+	unsigned int round, i, k, len, alpha, min_mem;
+	char name[64];
+
+	srand( 16 );
+	for( round = 0; round < 200; round++ ){
+		alpha = 1 + rand() % 4;
+		min_mem = 1 + rand() % 4;
+		strings.assign( 1 + rand() % 8, "" );
+		for( i = 0; i < strings.size(); i++ ){
+			for( len = 1 + rand() % 30, k = 0; k < len; k++ )
+				strings[i] += ( char )( 'a' + rand() % alpha );
+		}
+		query.clear();
+		while( query.size() < 80 ){
+			if( rand() % 3 == 0 ){
+				i = rand() % strings.size();
+				query += strings[i].substr( rand() % strings[i].size() );
+			}
+			else
+				query += ( char )( 'a' + rand() % ( alpha + 1 ) );
+		}
+		if( test_scan( strings, query, min_mem, 1 + rand() % 7, got ) )
+			return 1;
+		test_brute( strings, query, min_mem, want );
+		sprintf( name, "random round %u", round );
+		if( test_same( name, got, want ) )
+			return 1;
+	}
+	return 0;
+}
+
+/* a^n against a^n and a string with a few b: the MEMs at each
+* position leave near the top of paths n nodes deep */
+static int test_periodic( void )
+{
+	vector< string > strings( 2 );
+	vector< CTREE_MEM > got, want;
+	unsigned int i;
+
+	for( i = 0; i < 300; i++ ){
+		strings[0] += 'a';
+		strings[1] += i % 37 == 0 ? 'b' : 'a';
+	}
+	if( test_scan( strings, strings[0], 3, 64, got ) )
+		return 1;
+	test_brute( strings, strings[0], 3, want );
+	return test_same( "periodic", got, want );
+}
+
+int main( void )
+{
+	if( test_fixed() || test_random() || test_periodic() )
+		return 1;
+	printf( "match_scan: ok\n" );
+	return 0;
+}
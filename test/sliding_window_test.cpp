@@ -0,0 +1,437 @@
+/* Randomized checks of the sliding window of suffix_tree.h
+*
+*   g++ -std=c++11 -O2 -Isrc test/sliding_window_test.cpp src/[a-z]*.cpp -lpthread
+*
+* Inserts, evictions and merges are interleaved at random, and after
+* each step the tree is compared with one built again from the live
+* strings: the same nodes, labels, leaves and counts, valid suffix
+* links, node numbers and child indexes, and the same occurrences.
+* Runs over random strings, periodic strings and strings of a large
+* alphabet, whose nodes get child indexes of every kind.
+* Exits with 1 on the first failure.
+*/
+
+#include "suffix_tree.h"
+#include <stdio.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#define TEST_RANDOM    0
+#define TEST_PERIODIC  1
+#define TEST_FANOUT    2
+
+static const char *test_mode_name[] = { "random", "periodic", "fan-out" };
+
+/* child indexes seen by test_valid, by kind */
+static unsigned long test_index_kinds[3];
+
+/* A symbol of an alphabet of alpha: letters from a, or for a large
+* alphabet the byte values from 1 */
+static char test_symbol( unsigned int alpha )
+{
+	return ( char )( alpha > 26 ? 1 + rand() % alpha : 'a' + rand() % alpha );
+}
+
+/* The label of the path from the root to node */
+static string test_path( NODE *node )
+{
+	vector< NODE * > up;
+	string path;
+	int i;
+
+	for( ; node->parent != node; node = node->parent )
+		up.push_back( node );
+	for( i = ( int )up.size() - 1; i >= 0; i-- ){
+		if( !EMPTY_EDGE( up[i] ) )
+			path.append( up[i]->start_char, up[i]->edgelen );
+	}
+	return path;
+}
+
+static void test_collect( NODE *node, set< NODE * > &nodes )
+{
+	CHILD_STRUCT *c;
+
+	nodes.insert( node );
+	for( c = node->children; c != NULL; c = c->next )
+		test_collect( c->child, nodes );
+}
+
+/* The invariants of the subtree of node, whose path is path: parent
+* pointers, ordered children found through stree_get_child, no unary
+* internal node, suffix links to live nodes, unique node numbers, and
+* leaves holding suffixes of live strings */
+static int test_valid( SUFFIXTREE *tree, NODE *node, const string &path, set< NODE * > &nodes,
+	set< unsigned int > &nums, const char **err )
+{
+	CHILD_STRUCT *c;
+	STRINGID s;
+	string p = path;
+	unsigned int pos, len, kids;
+	int prev, ch;
+
+	if( !EMPTY_EDGE( node ) )
+		p.append( node->start_char, node->edgelen );
+	if( node->char_depth != p.size() ){
+		*err = "character depth";
+		return 1;
+	}
+	if( node != tree->root ){
+		if( !nums.insert( node->node_num ).second || node->node_num > tree->node_count ){
+			*err = "node number";
+			return 1;
+		}
+		if( node->node_type == INTERNODE && ( node->suffix_link == NULL ||
+			nodes.count( node->suffix_link ) == 0 || test_path( node->suffix_link ) != p.substr( 1 ) ) ){
+			*err = "suffix link";
+			return 1;
+		}
+	}
+	if( node->child_index != NULL )
+		test_index_kinds[node->child_index->kind]++;
+	prev = -1;
+	kids = 0;
+	for( c = node->children; c != NULL; c = c->next, kids++ ){
+		if( c->child->parent != node ){
+			*err = "parent pointer";
+			return 1;
+		}
+		ch = EMPTY_EDGE( c->child ) ? -1 : ( unsigned char )c->child->start_char[0];
+		if( ch < 0 ? c != node->children : ch <= prev ){
+			*err = "order of the children";
+			return 1;
+		}
+		if( ch >= 0 && stree_get_child( node, ( char )ch ) != c ){
+			*err = "child lookup";
+			return 1;
+		}
+		prev = ch;
+		if( test_valid( tree, c->child, p, nodes, nums, err ) )
+			return 1;
+	}
+	if( node != tree->root && node->node_type == INTERNODE && kids < 2 ){
+		*err = "unary internal node";
+		return 1;
+	}
+	if( node->node_type == INTERNODE )
+		return 0;
+	if( node->strings.count == 0 ){
+		*err = "empty leaf";
+		return 1;
+	}
+	for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); ){
+		if( s.str_id <= tree->str_evicted || s.str_id > tree->strnum ){
+			*err = "string ID of a leaf";
+			return 1;
+		}
+		len = stree_string_length( tree, s.str_id );
+		if( len - s.str_start != p.size() ||
+			memcmp( stree_find_string( tree, s.str_id ) + s.str_start, p.data(), p.size() ) ){
+			*err = "suffix of a leaf";
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* The type of a node, where a LEAF whose edge became empty when its
+* parent was split counts as the INTERLEAF it stands for */
+static int test_type( NODE *node )
+{
+	return node->node_type == LEAF && EMPTY_EDGE( node ) ? INTERLEAF : node->node_type;
+}
+
+/* The STRINGIDs of a leaf, numbered from 1 after the evicted strings */
+static void test_postings( NODE *node, unsigned int evicted, vector< STRINGID > &out )
+{
+	STRINGID s;
+	unsigned int pos;
+
+	out.clear();
+	for( pos = 0; stree_posting_next( &node->strings, &pos, &s ); ){
+		out.push_back( s );
+		out.back().str_id -= evicted;
+	}
+}
+
+/* The window tree w against the tree f of its live strings, node by
+* node; the live strings of w are numbered from evicted + 1 */
+static int test_same( NODE *w, NODE *f, unsigned int evicted, const char **err )
+{
+	vector< STRINGID > a, b;
+	CHILD_STRUCT *x, *y;
+	unsigned int i;
+
+	if( test_type( w ) != test_type( f ) || w->edgelen != f->edgelen || w->char_depth != f->char_depth ||
+		( !EMPTY_EDGE( w ) && memcmp( w->start_char, f->start_char, w->edgelen ) ) ){
+		*err = "node";
+		return 1;
+	}
+	if( w->node_type == INTERNODE && ( w->stringid_num != f->stringid_num ||
+		w->embedding_num != f->embedding_num ) ){
+		*err = "counts of an internal node";
+		return 1;
+	}
+	if( w->node_type != INTERNODE ){
+		test_postings( w, evicted, a );
+		test_postings( f, 0, b );
+		for( i = 0; i < a.size() && a.size() == b.size(); i++ ){
+			if( a[i].str_id != b[i].str_id || a[i].str_start != b[i].str_start )
+				break;
+		}
+		if( i < a.size() || a.size() != b.size() ){
+			*err = "strings of a leaf";
+			return 1;
+		}
+	}
+	for( x = w->children, y = f->children; x != NULL && y != NULL; x = x->next, y = y->next ){
+		if( test_same( x->child, y->child, evicted, err ) )
+			return 1;
+	}
+	if( x != NULL || y != NULL ){
+		*err = "children";
+		return 1;
+	}
+	return 0;
+}
+
+/* The occurrences of pattern in the window against those in the live strings */
+static int test_occurrences( SUFFIXTREE *tree, deque< string > &live, const string &pattern )
+{
+	STREE_OCC_ITER it;
+	STRINGID s;
+	unsigned int want, got, i;
+	size_t j;
+
+	for( i = 0, want = 0; i < live.size(); i++ ){
+		for( j = 0; j + pattern.size() <= live[i].size(); j++ )
+			want += live[i].compare( j, pattern.size(), pattern ) == 0;
+	}
+	got = 0;
+	if( stree_occ_begin( tree, ( char * )pattern.c_str(), pattern.size(), &it ) == 0 ){
+		while( stree_occ_next( &it, &s ) ){
+			if( s.str_id <= tree->str_evicted || s.str_id > tree->strnum ||
+				live[s.str_id - tree->str_evicted - 1].compare( s.str_start, pattern.size(), pattern ) )
+				return 1;
+			got++;
+		}
+	}
+	return got != want;
+}
+
+/* The window tree against a tree built again from the live strings */
+static int test_check( SUFFIXTREE *tree, deque< string > &live, unsigned int alpha, const char **err )
+{
+	SUFFIXTREE f;
+	set< NODE * > nodes;
+	set< unsigned int > nums;
+	string pattern;
+	char *s;
+	unsigned int i, j, k, len;
+	int ret;
+
+	if( tree->strnum - tree->str_evicted != live.size() ){
+		*err = "number of live strings";
+		return 1;
+	}
+	for( i = 0; i < live.size(); i++ ){
+		s = stree_find_string( tree, tree->str_evicted + 1 + i );
+		if( s == NULL || live[i] != s ){
+			*err = "text of a live string";
+			return 1;
+		}
+	}
+	if( tree->str_evicted > 0 && stree_find_string( tree, tree->str_evicted ) != NULL ){
+		*err = "evicted string still found";
+		return 1;
+	}
+	if( tree->root == NULL ){
+		*err = "no root";
+		return !live.empty();
+	}
+	test_collect( tree->root, nodes );
+	if( test_valid( tree, tree->root, "", nodes, nums, err ) )
+		return 1;
+
+	stree_init( &f );
+	for( i = 0; i < live.size(); i++ )
+		stree_insert_string_len( &f, ( char * )live[i].c_str(), live[i].size() );
+	if( f.root == NULL ){
+		*err = "nodes left in an empty window";
+		ret = tree->root->children != NULL;
+	}
+	else{
+		stree_count_strings( tree );
+		stree_count_strings( &f );
+		ret = test_same( tree->root, f.root, tree->str_evicted, err );
+	}
+	stree_destroy( &f );
+	if( ret )
+		return 1;
+
+	/* random patterns, and every other one taken from a live string */
+	for( k = 0; k < 10; k++ ){
+		pattern.clear();
+		for( len = 1 + rand() % 4, i = 0; i < len; i++ )
+			pattern += test_symbol( alpha );
+		j = live.empty() ? 0 : rand() % live.size();
+		if( k % 2 && !live.empty() && !live[j].empty() )
+			pattern = live[j].substr( rand() % live[j].size(), len );
+		if( test_occurrences( tree, live, pattern ) ){
+			*err = "occurrences";
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static string test_string( int mode, unsigned int alpha, deque< string > &live )
+{
+	string s, period;
+	unsigned int i, len;
+
+	if( mode == TEST_RANDOM && !live.empty() && rand() % 4 == 0 )
+		return live[rand() % live.size()];
+	if( mode == TEST_PERIODIC ){
+		for( len = 1 + rand() % 3, i = 0; i < len; i++ )
+			period += test_symbol( alpha );
+		for( len = rand() % 100; s.size() < len; )
+			s += period;
+		return s;
+	}
+	for( len = rand() % ( rand() % 4 ? 20 : 100 ), i = 0; i < len; i++ )
+		s += test_symbol( alpha );
+	return s;
+}
+
+/* Evict the oldest strings of the model as stree_window_trim does */
+static void test_trim( deque< string > &live, unsigned int max_strings, unsigned long long max_bytes )
+{
+	unsigned long long bytes;
+	unsigned int i;
+
+	for( bytes = 0, i = 0; i < live.size(); i++ )
+		bytes += live[i].size();
+	while( !live.empty() && ( ( max_strings && live.size() > max_strings ) || ( max_bytes && bytes > max_bytes ) ) ){
+		bytes -= live.front().size();
+		live.pop_front();
+	}
+}
+
+/* A tree of a few strings, some of them evicted, merged into tree */
+static int test_merge( SUFFIXTREE *tree, deque< string > &live, int mode, unsigned int alpha )
+{
+	SUFFIXTREE b;
+	deque< string > added;
+	string s;
+	unsigned int i, num, keep;
+
+	stree_init( &b );
+	keep = 1 + rand() % 3;
+	for( num = rand() % 5, i = 0; i < num; i++ ){
+		s = test_string( mode, alpha, live );
+		added.push_back( s );
+		if( stree_window_insert( &b, ( char * )s.c_str(), s.size(), keep, 0 ) ){
+			stree_destroy( &b );
+			return 1;
+		}
+	}
+	test_trim( added, keep, 0 );
+	live.insert( live.end(), added.begin(), added.end() );
+	if( stree_merge( tree, &b ) ){
+		stree_destroy( &b );
+		return 1;
+	}
+	stree_destroy( &b );
+	return 0;
+}
+
+/* One step on the window and on its model */
+static int test_step( SUFFIXTREE *tree, deque< string > &live, int mode, unsigned int alpha,
+	unsigned int max_strings, unsigned long long max_bytes )
+{
+	STREE_BUILDER b;
+	string s;
+	size_t pos, n;
+	int op, ret;
+
+	op = rand() % 10;
+	if( op == 0 ){
+		if( live.empty() )
+			return 0;
+		live.pop_front();
+		return stree_evict_string( tree );
+	}
+	if( op == 1 ){
+		if( test_merge( tree, live, mode, alpha ) )
+			return 1;
+		test_trim( live, max_strings, max_bytes );
+		return stree_window_trim( tree, max_strings, max_bytes );
+	}
+	s = test_string( mode, alpha, live );
+	live.push_back( s );
+	test_trim( live, max_strings, max_bytes );
+	if( op < 6 )
+		return stree_window_insert( tree, ( char * )s.c_str(), s.size(), max_strings, max_bytes );
+	if( op < 8 )
+		ret = stree_insert_string_len( tree, ( char * )s.c_str(), s.size() );
+	else{
+		stree_builder_init( &b, tree );
+		for( pos = 0, ret = 0; pos < s.size() && ret == 0; pos += n ){
+			n = min( ( size_t )( 1 + rand() % 8 ), s.size() - pos );
+			ret = stree_builder_append( &b, s.data() + pos, n );
+		}
+		ret = ret || stree_builder_end_string( &b );
+		stree_builder_free( &b );
+	}
+	return ret || stree_window_trim( tree, max_strings, max_bytes );
+}
+
+static int test_mode( int mode, unsigned int rounds )
+{
+	SUFFIXTREE tree;
+	deque< string > live;
+	unsigned int round, step, steps, alpha, max_strings;
+	unsigned long long max_bytes;
+	const char *err;
+
+	for( round = 0; round < rounds; round++ ){
+		if( mode == TEST_FANOUT )
+			alpha = 20 + rand() % 180;
+		else
+			alpha = 1 + rand() % ( mode == TEST_PERIODIC ? 2 : 4 );
+		max_strings = rand() % 4 ? 1 + rand() % 30 : 0;
+		max_bytes = rand() % 3 == 0 || max_strings == 0 ? 1 + rand() % 400 : 0;
+		steps = 20 + rand() % 100;
+		stree_init( &tree );
+		live.clear();
+		for( step = 0; step < steps; step++ ){
+			err = "step failed";
+			if( test_step( &tree, live, mode, alpha, max_strings, max_bytes ) ||
+				test_check( &tree, live, alpha, &err ) ){
+				printf( "%s round %u step %u: %s (evicted %u, base %u)\n", test_mode_name[mode],
+					round, step, err, tree.str_evicted, tree.str_base );
+				stree_destroy( &tree );
+				return 1;
+			}
+		}
+		stree_destroy( &tree );
+	}
+	return 0;
+}
+
+int main( void )
+{
+	srand( 25 );
+	if( test_mode( TEST_RANDOM, 150 ) || test_mode( TEST_PERIODIC, 100 ) || test_mode( TEST_FANOUT, 30 ) )
+		return 1;
+	if( !test_index_kinds[CHILD_SMALL] || !test_index_kinds[CHILD_SORTED] || !test_index_kinds[CHILD_DIRECT] ){
+		printf( "child indexes not covered: %lu small, %lu sorted, %lu direct\n", test_index_kinds[CHILD_SMALL],
+			test_index_kinds[CHILD_SORTED], test_index_kinds[CHILD_DIRECT] );
+		return 1;
+	}
+	printf( "sliding_window: ok\n" );
+	return 0;
+}